@@ -0,0 +1,121 @@
+#include "AsyncLogger.h"
+
+#include <chrono>
+
+// the writer sleeps this long when the queue is empty
+static const int POLL_INTERVAL_MS = 20;
+
+AsyncLogger::AsyncLogger(std::string filename, int flushIntervalMs) : cells(new Cell[CAPACITY]) {
+	// a cell is free for the push at position i when its sequence is i, and holds a line for the pop at i when it is i + 1
+	for (size_t i = 0; i < CAPACITY; i++) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	pushPosition.store(0, std::memory_order_relaxed);
+	popPosition.store(0, std::memory_order_relaxed);
+	flushInterval = flushIntervalMs;
+	stop = false;
+
+	file.open(filename);
+	if (file.is_open()) {
+		writer = std::thread(&AsyncLogger::run, this);
+	}
+}
+
+AsyncLogger::~AsyncLogger() {
+	if (writer.joinable()) {
+		stop = true;
+		wakeup.notify_one();
+		writer.join();
+	}
+}
+
+void AsyncLogger::push(std::string line) {
+	if (!writer.joinable()) {
+		return;
+	}
+	while (!tryPush(line)) {
+		wakeup.notify_one();
+		std::this_thread::yield();
+	}
+}
+
+bool AsyncLogger::isOpen() {
+	return file.is_open();
+}
+
+bool AsyncLogger::tryPush(std::string& line) {
+	size_t position = pushPosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &cells[position & (CAPACITY - 1)];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		if (sequence == position) {
+			if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (sequence < position) {
+			// full
+			return false;
+		}
+		else {
+			position = pushPosition.load(std::memory_order_relaxed);
+		}
+	}
+	cell->line = std::move(line);
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool AsyncLogger::tryPop(std::string& line) {
+	size_t position = popPosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &cells[position & (CAPACITY - 1)];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		if (sequence == position + 1) {
+			if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (sequence < position + 1) {
+			// empty
+			return false;
+		}
+		else {
+			position = popPosition.load(std::memory_order_relaxed);
+		}
+	}
+	line = std::move(cell->line);
+	cell->sequence.store(position + CAPACITY, std::memory_order_release);
+	return true;
+}
+
+void AsyncLogger::run() {
+	std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+	bool unflushed = false;
+	std::string line;
+	while (true) {
+		// read the flag first, so the lines pushed before the logger is destroyed are still written
+		bool stopping = stop;
+		while (tryPop(line)) {
+			file << line << '\n';
+			unflushed = true;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (unflushed && flushInterval >= 0 && std::chrono::duration_cast<std::chrono::milliseconds>(now - lastFlush).count() >= flushInterval) {
+			file.flush();
+			lastFlush = now;
+			unflushed = false;
+		}
+
+		if (stopping) {
+			break;
+		}
+		std::unique_lock<std::mutex> lock(mutex);
+		wakeup.wait_for(lock, std::chrono::milliseconds(flushInterval == 0 ? 1 : POLL_INTERVAL_MS));
+	}
+	file.flush();
+	file.close();
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+// Writes lines to a file on a background thread, so callers never wait for the disk.
+// Lines are passed through a bounded lock-free queue which any thread may push to.
+class AsyncLogger
+{
+public:
+	static const int CAPACITY = 4096;
+
+	// flushIntervalMs: 0 flushes as soon as lines are written, negative only when the logger is destroyed
+	AsyncLogger(std::string filename, int flushIntervalMs);
+	~AsyncLogger();
+
+	// waits for the writer only if the queue is full
+	void push(std::string line);
+	bool isOpen();
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		std::string line;
+	};
+
+	bool tryPush(std::string& line);
+	bool tryPop(std::string& line);
+	void run();
+
+	std::unique_ptr<Cell[]> cells;
+	std::atomic<size_t> pushPosition;
+	std::atomic<size_t> popPosition;
+
+	std::ofstream file;
+	int flushInterval;
+	std::atomic<bool> stop;
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::thread writer;
+};
+
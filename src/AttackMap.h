@@ -1,6 +0,0 @@
-#pragma once
-
-class AttackMap {
-public:
-	u64 map[2];
-};
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include "types.h"
+#include "Color.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// helpers for 64 bit square sets, bit i is the 8x8 square i (a1 = 0, h8 = 63)
+class Bitboard {
+public:
+	static const u64 FILE_A = 0x0101010101010101ULL;
+	static const u64 FILE_H = FILE_A << 7;
+	static const u64 RANK_1 = 0xFFULL;
+
+	static int popCount(u64 b) {
+#ifdef _MSC_VER
+		return (int)__popcnt64(b);
+#else
+		return __builtin_popcountll(b);
+#endif
+	}
+
+	static int lsb(u64 b) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, b);
+		return (int)index;
+#else
+		return __builtin_ctzll(b);
+#endif
+	}
+
+	static int popLsb(u64& b) {
+		int square = lsb(b);
+		b &= b - 1;
+		return square;
+	}
+
+	static u64 squareBit(int square64) {
+		return (u64)1 << square64;
+	}
+
+	static u64 fileMask(int file) {
+		return FILE_A << file;
+	}
+
+	static u64 rankMask(int rank) {
+		return RANK_1 << (8 * rank);
+	}
+
+	static u64 adjacentFilesMask(int file) {
+		return ((FILE_A << file) << 1 & ~FILE_A) | ((FILE_A << file) >> 1 & ~FILE_H);
+	}
+
+	// all squares in front of the given square from the view of color, excluding its own rank
+	static u64 forwardRanksMask(int color, int square64) {
+		int rank = square64 >> 3;
+		if (color == Color::WHITE) {
+			return rank < 7 ? ~(u64)0 << (8 * (rank + 1)) : 0;
+		}
+		return ((u64)1 << (8 * rank)) - 1;
+	}
+
+	static u64 shiftUp(u64 b) {
+		return b << 8;
+	}
+
+	static u64 shiftDown(u64 b) {
+		return b >> 8;
+	}
+
+	static u64 shiftLeft(u64 b) {
+		return (b >> 1) & ~FILE_H;
+	}
+
+	static u64 shiftRight(u64 b) {
+		return (b << 1) & ~FILE_A;
+	}
+};
@@ -3,9 +3,16 @@
 #include <iostream>
 #include <sstream>
 #include <cctype>
+#include <algorithm>
+#include <cstring>
 
 #include "CastlingRights.h"
 #include "Piece.h"
+#include "Bitboard.h"
+#include "DeltaTables.h"
+#include "Profiler.h"
+#include "evaluation/DefaultEvaluator.h"
+#include "evaluation/PieceSquareTables.h"
 
 Board::Board() : zobristHasher(this) {
 	pieceListHolder[0] = &whitePieces;
@@ -17,9 +24,12 @@ Board::Board() : zobristHasher(this) {
 
 	enpassantSquare = 128;
 	enpassantPiece = nullptr;
+	halfmoveClock = 0;
+	kings[0] = kings[1] = nullptr;
+	nnueNetwork = nullptr;
 
 	colorToMove = Color::WHITE;
-	attackMap = { 0 };
+	computeIncrementalScores();
 
 	hashHistory.reserve(200);
 	hashHistory.clear();
@@ -43,8 +53,12 @@ void Board::loadFEN(std::string fen) {
 	// white/black, queenside/kingside
 	int rookSquares[2][2] = { { 0, 7 }, { 112, 119 } };
 
-	whitePieces.clear();
-	blackPieces.clear();
+	for (int c = 0; c < 2; c++) {
+		for (int j = 0; j < pieceListHolder[c]->size(); j++) {
+			delete (*pieceListHolder[c])[j];
+		}
+		pieceListHolder[c]->clear();
+	}
 
 	int i = 0;
 	for (i = 0; i < len; i++) {
@@ -138,13 +152,23 @@ void Board::loadFEN(std::string fen) {
 	}
 	i++;
 
+	halfmoveClock = 0;
+	while (i < len && isdigit(fen[i])) {
+		halfmoveClock = halfmoveClock * 10 + fen[i] - '0';
+		i++;
+	}
+
 	refillBoardByPieceList();
 
+	enpassantSquare = 128;
+	enpassantPiece = nullptr;
 	if (enpassantFile >= 0) {
 		enpassantSquare = enpassantFile + enpassantRank * 16;
 		enpassantPiece = enpassantRank == 3 ? board[enpassantSquare + 16] : board[enpassantSquare - 16];
 	}
 
+	computeIncrementalScores();
+	refreshAccumulators();
 	zobristHasher.hashNew();
 	hashHistory.clear();
 	moveStringHistory.clear();
@@ -176,7 +200,7 @@ bool Board::isMate(int color) {
 	}
 
 	Move moves[128];
-	int n = generateMoves(color, moves);
+	int n = generateEvasions(color, moves);
 	for (int i = 0; i < n; i++) {
 		makeMove(moves[i]);
 		if (!inCheck(color)) {
@@ -213,17 +237,14 @@ bool Board::inCheck(int color) {
 }
 
 bool Board::sufficientMaterial() {
-	for (int c = 0; c < 2; c++) {
-		if (pieceCount[c][Piece::Rook] > 0 || pieceCount[c][Piece::Queen] > 0 || pieceCount[c][Piece::Pawn] > 0 ||
-			pieceCount[c][Piece::Bishop] > 1 || (pieceCount[c][Piece::Bishop] > 0 && pieceCount[c][Piece::Knight] > 0))
-			return true;
-	}
-	return false;
+	return getMaterialEntry()->sufficientMaterial;
 }
 
 bool Board::isRepetition() {
+	// only positions since the last capture or pawn move with the same side to move can repeat, the earliest 4 plies ago
+	int end = std::max(0, (int)hashHistory.size() - halfmoveClock);
 	bool f = false;
-	for (int i = 0; i < hashHistory.size(); i++) {
+	for (int i = (int)hashHistory.size() - 4; i >= end; i -= 2) {
 		if (getHash() == hashHistory[i]) {
 			if (f) {
 				return true;
@@ -236,6 +257,49 @@ bool Board::isRepetition() {
 	return false;
 }
 
+bool Board::hasUpcomingRepetition(int ply) {
+	int size = hashHistory.size();
+	int end = std::min(halfmoveClock, size);
+	for (int i = 3; i <= end; i += 2) {
+		int square1, square2;
+		if (!ZobristHasher::findReversibleMove(getHash() ^ hashHistory[size - i], square1, square2)) {
+			continue;
+		}
+
+		// the side to move has to be able to make the move now
+		if ((board[square1] == nullptr) == (board[square2] == nullptr)) {
+			continue;
+		}
+		Piece* piece = board[square1] != nullptr ? board[square1] : board[square2];
+		if (piece->color != colorToMove) {
+			continue;
+		}
+		int direction = DeltaTables::getDirection(square1, square2);
+		int sq = square1 + direction;
+		while (direction != 0 && sq != square2 && board[sq] == nullptr) {
+			sq += direction;
+		}
+		if (direction != 0 && sq != square2) {
+			continue;
+		}
+
+		// inside the search one repetition is enough, positions before the root must have occurred twice
+		if (ply > i) {
+			return true;
+		}
+		for (int j = i + 4; j <= end; j += 2) {
+			if (hashHistory[size - j] == hashHistory[size - i]) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool Board::isFiftyMoveDraw() {
+	return halfmoveClock >= 100 && !isMate(colorToMove);
+}
+
 bool Board::isLegalMove(Move& move) {
 	Move moves[128];
 	int n = generateMoves(move.color, moves);
@@ -247,46 +311,58 @@ bool Board::isLegalMove(Move& move) {
 }
 
 bool Board::isAttackedBy(int square, int color) {
-	if (attackMap.map[color] == 0) {
-		std::vector<Piece*>* pieces = getPieceList(color);
+	std::vector<Piece*>* pieces = getPieceList(color);
 
-		for (int i = 0; i < pieces->size(); i++) {
-			Piece* current = (*pieces)[i];
-			if (!current->alive) {
-				continue;
-			}
+	for (int i = 0; i < pieces->size(); i++) {
+		Piece* current = (*pieces)[i];
+		if (!current->alive || !DeltaTables::canAttack(color, current->type, current->square, square)) {
+			continue;
+		}
+		if (!current->sliding) {
+			return true;
+		}
 
-			for (int j = 0; j < current->numVectorMoves; j++) {
-				int dest = current->square;
-				do {
-					dest += current->vectorMoves[j];
-
-					// make sure we don't move off the board
-					if (!isSquareOnBoard(dest)) {
-						break;
-					}
-
-					// special rules for pawns
-					if (current->type == Piece::Pawn) {
-						dest = current->square + current->vectorMoves[j] - 1;
-						if (isSquareOnBoard(dest)) {
-							attackMap.map[color] |= ((u64)1 << convert88To64Square(dest));
-						}
-
-						dest = current->square + current->vectorMoves[j] + 1;
-						if (isSquareOnBoard(dest)) {
-							attackMap.map[color] |= ((u64)1 << convert88To64Square(dest));
-						}
-
-						break;
-					}
-
-					attackMap.map[color] |= ((u64)1 << convert88To64Square(dest));
-				} while (current->sliding && isEmptySquare(dest));
+		// walk the ray towards the square
+		int step = DeltaTables::getDirection(current->square, square);
+		int sq = current->square + step;
+		while (sq != square && board[sq] == nullptr) {
+			sq += step;
+		}
+		if (sq == square) {
+			return true;
+		}
+	}
+	return false;
+}
+
+u64 Board::getPieceAttacks(Piece* piece) {
+	u64 attacks = 0;
+
+	// special rules for pawns
+	if (piece->type == Piece::Pawn) {
+		for (int sq = -1; sq <= 1; sq += 2) {
+			int dest = piece->square + piece->vectorMoves[0] + sq;
+			if (isSquareOnBoard(dest)) {
+				attacks |= Bitboard::squareBit(convert88To64Square(dest));
 			}
 		}
+		return attacks;
+	}
+
+	for (int j = 0; j < piece->numVectorMoves; j++) {
+		int dest = piece->square;
+		do {
+			dest += piece->vectorMoves[j];
+
+			// make sure we don't move off the board
+			if (!isSquareOnBoard(dest)) {
+				break;
+			}
+
+			attacks |= Bitboard::squareBit(convert88To64Square(dest));
+		} while (piece->sliding && isEmptySquare(dest));
 	}
-	return attackMap.map[color] & ((u64)1 << convert88To64Square(square));
+	return attacks;
 }
 
 int Board::generateCaptures(Move* captures) {
@@ -294,69 +370,64 @@ int Board::generateCaptures(Move* captures) {
 }
 
 int Board::generateCaptures(int color, Move* captures) {
-	int numCaptures = 0;
-	std::vector<Piece*>* pieces = getPieceList(color);
+	return color == Color::WHITE ? generate<Color::WHITE, CAPTURES>(captures) : generate<Color::BLACK, CAPTURES>(captures);
+}
 
-	for (int i = 0; i < pieces->size(); i++) {
-		Piece* current = (*pieces)[i];
-		if (!current->alive) {
-			continue;
-		}
+int Board::generateQuiets(int color, Move* moves) {
+	return color == Color::WHITE ? generate<Color::WHITE, QUIETS>(moves) : generate<Color::BLACK, QUIETS>(moves);
+}
 
-		for (int j = 0; j < current->numVectorMoves; j++) {
-			int dest = current->square;
-			do {
-				dest += current->vectorMoves[j];
+int Board::generateEvasions(int color, Move* moves) {
+	return color == Color::WHITE ? generate<Color::WHITE, EVASIONS>(moves) : generate<Color::BLACK, EVASIONS>(moves);
+}
 
-				// make sure we don't move off the board
-				if (!isSquareOnBoard(dest)) {
-					break;
-				}
+int Board::generateMoves(Move* moves) {
+	return generateMoves(colorToMove, moves);
+}
 
-				// special rules for pawns
-				if (current->type == Piece::Pawn) {
-					for (int sq = -1; sq <= 1; sq += 2) {
-						dest = current->square + current->vectorMoves[j] + sq;
-						if (isSquareOnBoard(dest)) {
-							if (!isEmptySquare(dest) && (board[dest]->color != color)) {
-								// check promotion
-								if (dest >> 4 == 0 || dest >> 4 == 7) {
-									captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Queen);
-									captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Knight);
-									captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Rook);
-									captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Bishop);
-								}
-								else {
-									captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights);
-								}
-							}
-							else if (dest == enpassantSquare && enpassantPiece->color != color) {
-								captures[numCaptures++] = Move(color, current->square, dest, current, enpassantPiece, enpassantSquare, enpassantPiece, castlingRights);
-							}
-						}
-					}
-					break;
-				}
+int Board::generateMoves(int color, Move* moves) {
+	return color == Color::WHITE ? generate<Color::WHITE, ALL>(moves) : generate<Color::BLACK, ALL>(moves);
+}
 
-				// look if capture a piece
-				if (!isEmptySquare(dest) && (board[dest]->color != color)) {
-					captures[numCaptures++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights);
-				}
-			} while (current->sliding && isEmptySquare(dest));
+u64 Board::getEvasionTargets(int color) {
+	Piece* king = getKing(color);
+	u64 kingBit = Bitboard::squareBit(convert88To64Square(king->square));
+	u64 targets = 0;
+	int checkers = 0;
+
+	std::vector<Piece*>* pieces = getPieceList(Color::invert(color));
+	for (int i = 0; i < pieces->size(); i++) {
+		Piece* current = (*pieces)[i];
+		if (!current->alive || (getPieceAttacks(current) & kingBit) == 0) {
+			continue;
+		}
+		checkers++;
+		targets |= Bitboard::squareBit(convert88To64Square(current->square));
+
+		// squares between a sliding checker and the king
+		if (current->sliding) {
+			int step = DeltaTables::getDirection(king->square, current->square);
+			for (int sq = king->square + step; sq != current->square; sq += step) {
+				targets |= Bitboard::squareBit(convert88To64Square(sq));
+			}
 		}
 	}
-	return numCaptures;
-}
 
+	// only the king can escape a double check
+	return checkers > 1 ? 0 : targets;
+}
 
-int Board::generateMoves(Move* moves) {
-	return generateMoves(colorToMove, moves);
+template <Board::GenType genType>
+static inline bool isTarget(int square, u64 targets) {
+	return genType != Board::EVASIONS || (targets & Bitboard::squareBit(Board::convert88To64Square(square))) != 0;
 }
 
-int Board::generateMoves(int color, Move* moves) {
+template <int color, Board::GenType genType>
+int Board::generate(Move* moves) {
 	int numMoves = 0;
 
-	bool incheck = inCheck(color);
+	bool incheck = (genType == ALL || genType == QUIETS) && inCheck(color);
+	u64 targets = genType == EVASIONS ? getEvasionTargets(color) : ~0ULL;
 
 	std::vector<Piece*>* pieces = getPieceList(color);
 
@@ -366,89 +437,154 @@ int Board::generateMoves(int color, Move* moves) {
 			continue;
 		}
 
-		// castling
-		if (current->type == Piece::King && !incheck) {
-			int dest = current->square + 2;
-			if (castlingRights.canCastleKingside(color) && isEmptySquare(dest - 1) && isEmptySquare(dest) && !isAttackedBy(dest, Color::invert(color)) && !isAttackedBy(dest - 1, Color::invert(color))) {
-				moves[numMoves++] = Move(color, Move::Kingside, current, board[dest + 1], dest, dest - 1, enpassantSquare, enpassantPiece, castlingRights);
+		switch (current->type) {
+		case Piece::Pawn:
+			generatePawnMoves<color, genType>(current, targets, moves, numMoves);
+			break;
+		case Piece::Knight:
+			generatePieceMoves<color, genType, false>(current, Piece::KNIGHT_VECTORS, targets, moves, numMoves);
+			break;
+		case Piece::Bishop:
+			generatePieceMoves<color, genType, true>(current, Piece::BISHOP_VECTORS, targets, moves, numMoves);
+			break;
+		case Piece::Rook:
+			generatePieceMoves<color, genType, true>(current, Piece::ROOK_VECTORS, targets, moves, numMoves);
+			break;
+		case Piece::Queen:
+			generatePieceMoves<color, genType, true>(current, Piece::KING_VECTORS, targets, moves, numMoves);
+			break;
+		case Piece::King:
+			if ((genType == ALL || genType == QUIETS) && !incheck) {
+				generateCastlingMoves<color>(current, moves, numMoves);
 			}
+			// the king may leave the check in any direction
+			generatePieceMoves<color, genType, false>(current, Piece::KING_VECTORS, ~0ULL, moves, numMoves);
+			break;
+		default:
+			break;
+		}
+	}
+	return numMoves;
+}
+
+template <int color, Board::GenType genType, bool sliding, int numDirections>
+void Board::generatePieceMoves(Piece* piece, const int (&directions)[numDirections], u64 targets, Move* moves, int& numMoves) {
+	for (int j = 0; j < numDirections; j++) {
+		int dest = piece->square;
+		do {
+			dest += directions[j];
 
-			dest = current->square - 2;
-			if (castlingRights.canCastleQueenside(color) && isEmptySquare(dest - 1) && isEmptySquare(dest) && isEmptySquare(dest + 1) && !isAttackedBy(dest, Color::invert(color)) && !isAttackedBy(dest + 1, Color::invert(color))) {
-				moves[numMoves++] = Move(color, Move::Queenside, current, board[dest - 2], dest, dest + 1, enpassantSquare, enpassantPiece, castlingRights);
+			// make sure we don't move off the board
+			if (!isSquareOnBoard(dest)) {
+				break;
+			}
+
+			Piece* target = board[dest];
+			if (target != nullptr) {
+				if (genType != QUIETS && target->color != color && isTarget<genType>(dest, targets)) {
+					moves[numMoves++] = Move(color, piece->square, dest, piece, target, enpassantSquare, enpassantPiece, castlingRights);
+				}
+				break;
 			}
+
+			if (genType != CAPTURES && isTarget<genType>(dest, targets)) {
+				moves[numMoves++] = Move(color, piece->square, dest, piece, nullptr, enpassantSquare, enpassantPiece, castlingRights);
+			}
+		} while (sliding);
+	}
+}
+
+template <int color, Board::GenType genType>
+void Board::generatePawnMoves(Piece* pawn, u64 targets, Move* moves, int& numMoves) {
+	const int forward = color == Color::WHITE ? 16 : -16;
+	const int startRank = color == Color::WHITE ? 1 : 6;
+
+	int dest = pawn->square + forward;
+	if (!isSquareOnBoard(dest)) {
+		return;
+	}
+	bool promotion = dest >> 4 == 0 || dest >> 4 == 7;
+
+	// move forward
+	if (genType != CAPTURES && isEmptySquare(dest)) {
+		if (isTarget<genType>(dest, targets)) {
+			if (promotion) {
+				addPromotions(color, pawn, dest, nullptr, moves, numMoves);
+			}
+			else {
+				moves[numMoves++] = Move(color, pawn->square, dest, pawn, nullptr, enpassantSquare, enpassantPiece, castlingRights);
+			}
+		}
+
+		// double move
+		if (pawn->square >> 4 == startRank && isEmptySquare(dest + forward) && isTarget<genType>(dest + forward, targets)) {
+			moves[numMoves++] = Move(color, pawn->square, dest + forward, pawn, nullptr, dest, pawn, enpassantSquare, enpassantPiece, castlingRights);
 		}
+	}
 
-		for (int j = 0; j < current->numVectorMoves; j++) {
-			int dest = current->square;
-			do {
-				dest += current->vectorMoves[j];
+	// capture moves
+	if (genType != QUIETS) {
+		for (int side = -1; side <= 1; side += 2) {
+			int captureDest = dest + side;
+			if (!isSquareOnBoard(captureDest)) {
+				continue;
+			}
 
-				// make sure we don't move off the board
-				if (!isSquareOnBoard(dest)) {
-					break;
+			Piece* target = board[captureDest];
+			if (target != nullptr && target->color != color) {
+				if (!isTarget<genType>(captureDest, targets)) {
+					continue;
 				}
-
-				// special rules for pawns
-				if (current->type == Piece::Pawn) {
-					// move forward
-					if (isEmptySquare(dest)) {
-						// check promotion
-						if (dest >> 4 == 0 || dest >> 4 == 7) {
-							moves[numMoves++] = Move(color, current->square, dest, current, nullptr, enpassantSquare, enpassantPiece, castlingRights, Piece::Queen);
-							moves[numMoves++] = Move(color, current->square, dest, current, nullptr, enpassantSquare, enpassantPiece, castlingRights, Piece::Knight);
-							moves[numMoves++] = Move(color, current->square, dest, current, nullptr, enpassantSquare, enpassantPiece, castlingRights, Piece::Rook);
-							moves[numMoves++] = Move(color, current->square, dest, current, nullptr, enpassantSquare, enpassantPiece, castlingRights, Piece::Bishop);
-						}
-						else {
-							moves[numMoves++] = Move(color, current->square, dest, current, nullptr, enpassantSquare, enpassantPiece, castlingRights);
-						}
-
-						// double move
-						if ((current->square >> 4 == 1 && color == Color::WHITE) || (current->square >> 4 == 6 && color == Color::BLACK)) {
-							dest += current->vectorMoves[j];
-							if (isSquareOnBoard(dest) && isEmptySquare(dest)) {
-								moves[numMoves++] = Move(color, current->square, dest, current, nullptr, dest - current->vectorMoves[j], current, enpassantSquare, enpassantPiece, castlingRights);
-							}
-						}
-					}
-
-					// capture moves
-					for (int sq = -1; sq <= 1; sq += 2) {
-						dest = current->square + current->vectorMoves[j] + sq;
-						if (isSquareOnBoard(dest)) {
-							if ((!isEmptySquare(dest)) && (board[dest]->color != color)) {
-								// check promotion
-								if (dest >> 4 == 0 || dest >> 4 == 7) {
-									moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Queen);
-									moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Knight);
-									moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Rook);
-									moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights, Piece::Bishop);
-								}
-								else {
-									moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights);
-								}
-							}
-							else if (dest == enpassantSquare && enpassantPiece->color != color) {
-								moves[numMoves++] = Move(color, current->square, dest, current, enpassantPiece, enpassantSquare, enpassantPiece, castlingRights);
-							}
-						}
-					}
-					break;
+				if (promotion) {
+					addPromotions(color, pawn, captureDest, target, moves, numMoves);
 				}
-
-				if (!isEmptySquare(dest) && board[dest]->color == color) {
-					break;
+				else {
+					moves[numMoves++] = Move(color, pawn->square, captureDest, pawn, target, enpassantSquare, enpassantPiece, castlingRights);
+				}
+			}
+			else if (captureDest == enpassantSquare && enpassantPiece->color != color) {
+				if (isTarget<genType>(captureDest, targets) || isTarget<genType>(enpassantPiece->square, targets)) {
+					moves[numMoves++] = Move(color, pawn->square, captureDest, pawn, enpassantPiece, enpassantSquare, enpassantPiece, castlingRights);
 				}
+			}
+		}
+	}
+}
 
-				moves[numMoves++] = Move(color, current->square, dest, current, board[dest], enpassantSquare, enpassantPiece, castlingRights);
+template <int color>
+void Board::generateCastlingMoves(Piece* king, Move* moves, int& numMoves) {
+	const int opp = Color::invert(color);
 
-			} while (current->sliding && isEmptySquare(dest));
-		}
+	int dest = king->square + 2;
+	if (castlingRights.canCastleKingside(color) && isEmptySquare(dest - 1) && isEmptySquare(dest) && !isAttackedBy(dest, opp) && !isAttackedBy(dest - 1, opp)) {
+		moves[numMoves++] = Move(color, Move::Kingside, king, board[dest + 1], dest, dest - 1, enpassantSquare, enpassantPiece, castlingRights);
+	}
+
+	dest = king->square - 2;
+	if (castlingRights.canCastleQueenside(color) && isEmptySquare(dest - 1) && isEmptySquare(dest) && isEmptySquare(dest + 1) && !isAttackedBy(dest, opp) && !isAttackedBy(dest + 1, opp)) {
+		moves[numMoves++] = Move(color, Move::Queenside, king, board[dest - 2], dest, dest + 1, enpassantSquare, enpassantPiece, castlingRights);
 	}
-	return numMoves;
 }
+
+void Board::addPromotions(int color, Piece* pawn, int dest, Piece* captured, Move* moves, int& numMoves) {
+	moves[numMoves++] = Move(color, pawn->square, dest, pawn, captured, enpassantSquare, enpassantPiece, castlingRights, Piece::Queen);
+	moves[numMoves++] = Move(color, pawn->square, dest, pawn, captured, enpassantSquare, enpassantPiece, castlingRights, Piece::Knight);
+	moves[numMoves++] = Move(color, pawn->square, dest, pawn, captured, enpassantSquare, enpassantPiece, castlingRights, Piece::Rook);
+	moves[numMoves++] = Move(color, pawn->square, dest, pawn, captured, enpassantSquare, enpassantPiece, castlingRights, Piece::Bishop);
+}
+
 void Board::makeMove(Move& move) {
+	PROFILE_SCOPE(MakeMove);
+	updateIncrementalScores(move, 1);
+
+	move.oldHalfmoveClock = halfmoveClock;
+	if (move.castlingMove == Move::None && (move.capturedPiece != nullptr || move.movingPiece->type == Piece::Pawn)) {
+		halfmoveClock = 0;
+	}
+	else {
+		halfmoveClock++;
+	}
+
 	// update en passant state
 	enpassantSquare = move.enpassantSquare;
 	enpassantPiece = move.enpassantPiece;
@@ -491,6 +627,8 @@ void Board::makeMove(Move& move) {
 
 		// check promotion
 		if (move.promotionType != Piece::None) {
+			pieceCount[move.color][Piece::Pawn]--;
+			pieceCount[move.color][move.promotionType]++;
 			move.movingPiece->type = move.promotionType;
 			move.movingPiece->sliding = Piece::isSliding(move.promotionType);
 			move.movingPiece->setupVectorMoves();
@@ -512,15 +650,22 @@ void Board::makeMove(Move& move) {
 		board[move.source] = nullptr;
 	}
 	colorToMove = Color::invert(colorToMove);
-	attackMap = { 0 };
 
 #ifdef _DEBUG
 	moveStringHistory.push_back(move.toString());
 #endif
 	hashHistory.push_back(getHash());
 	zobristHasher.updateHash(move);
+
+	if (nnueNetwork != nullptr) {
+		accumulators.push_back(accumulators.back());
+		nnueNetwork->updateAccumulator(this, accumulators.back(), move);
+	}
 }
 void Board::unmakeMove(Move& move) {
+	PROFILE_SCOPE(UnmakeMove);
+	updateIncrementalScores(move, -1);
+
 	//en passant
 	enpassantSquare = move.oldEnpassantSquare;
 	enpassantPiece = move.oldEnpassantPiece;
@@ -562,6 +707,8 @@ void Board::unmakeMove(Move& move) {
 
 		if (move.promotionType != Piece::None)
 		{
+			pieceCount[move.color][Piece::Pawn]++;
+			pieceCount[move.color][move.promotionType]--;
 			move.movingPiece->type = Piece::Pawn;
 			move.movingPiece->sliding = false;
 			move.movingPiece->setupVectorMoves();
@@ -572,13 +719,78 @@ void Board::unmakeMove(Move& move) {
 	}
 
 	colorToMove = Color::invert(colorToMove);
-	attackMap = { 0 };
+	halfmoveClock = move.oldHalfmoveClock;
 
 #ifdef _DEBUG
 	moveStringHistory.pop_back();
 #endif
 	hashHistory.pop_back();
 	zobristHasher.updateHash(move);
+
+	if (nnueNetwork != nullptr) {
+		accumulators.pop_back();
+	}
+}
+
+void Board::refreshAccumulators() {
+	accumulators.clear();
+	if (nnueNetwork == nullptr || kings[0] == nullptr || kings[1] == nullptr) {
+		return;
+	}
+	accumulators.reserve(256);
+	accumulators.push_back(NNUEAccumulator());
+	nnueNetwork->refreshAccumulator(this, accumulators.back(), Color::WHITE);
+	nnueNetwork->refreshAccumulator(this, accumulators.back(), Color::BLACK);
+}
+
+void Board::computeIncrementalScores() {
+	gamePhase = 0;
+	materialKey = 0;
+	for (int c = 0; c < 2; c++) {
+		material[c] = 0;
+		positionalScore[c] = Score(0, 0);
+
+		std::vector<Piece*>* pieces = pieceListHolder[c];
+		for (int i = 0; i < pieces->size(); i++) {
+			Piece* p = (*pieces)[i];
+			if (!p->alive) {
+				continue;
+			}
+			material[c] += DefaultEvaluator::PIECE_WORTH[p->type];
+			positionalScore[c] += PieceSquareTables::getValue(c, p->type, p->square);
+			gamePhase += PieceSquareTables::PHASE_WEIGHT[p->type];
+			materialKey += ZobristHasher::getMaterialKey(c, p->type);
+		}
+	}
+}
+
+// applies the changes of a move to the material and piece-square sums, the game phase and the material key, sign is -1 to take them back
+void Board::updateIncrementalScores(Move& move, int sign) {
+	int color = move.color;
+	Score delta(0, 0);
+	if (move.castlingMove != Move::None) {
+		delta += PieceSquareTables::getValue(color, Piece::King, move.destination) - PieceSquareTables::getValue(color, Piece::King, move.source);
+		delta += PieceSquareTables::getValue(color, Piece::Rook, move.castleRookDestination) - PieceSquareTables::getValue(color, Piece::Rook, move.castleRookSource);
+	}
+	else {
+		Piece::PieceType type = move.promotionType != Piece::None ? Piece::Pawn : move.movingPiece->type;
+		Piece::PieceType newType = move.promotionType != Piece::None ? move.promotionType : type;
+		delta += PieceSquareTables::getValue(color, newType, move.destination) - PieceSquareTables::getValue(color, type, move.source);
+
+		if (move.promotionType != Piece::None) {
+			material[color] += sign * (DefaultEvaluator::PIECE_WORTH[move.promotionType] - DefaultEvaluator::PIECE_WORTH[Piece::Pawn]);
+			gamePhase += sign * PieceSquareTables::PHASE_WEIGHT[move.promotionType];
+			materialKey += sign * (ZobristHasher::getMaterialKey(color, move.promotionType) - ZobristHasher::getMaterialKey(color, Piece::Pawn));
+		}
+		if (move.capturedPiece != nullptr) {
+			Piece* captured = move.capturedPiece;
+			material[captured->color] -= sign * DefaultEvaluator::PIECE_WORTH[captured->type];
+			positionalScore[captured->color] -= PieceSquareTables::getValue(captured->color, captured->type, captured->square) * sign;
+			gamePhase -= sign * PieceSquareTables::PHASE_WEIGHT[captured->type];
+			materialKey -= sign * ZobristHasher::getMaterialKey(captured->color, captured->type);
+		}
+	}
+	positionalScore[color] += delta * sign;
 }
 
 void Board::print(std::ostream& out) {
@@ -600,15 +812,19 @@ void Board::print(std::ostream& out) {
 	}
 }
 
+// captured pieces stay in the lists for unmakeMove, delete them once no move can be taken back
 void Board::cleanupDeadPieces()
 {
 	for (int c = 0; c < 2; c++) {
 		std::vector<Piece*>* pieces = pieceListHolder[c];
-		for (auto it = pieces->begin(); it != pieces->end(); ++it) {
-			if (!(*it)->alive) {
-				pieces->erase(it--);
+		auto end = std::remove_if(pieces->begin(), pieces->end(), [](Piece* piece) {
+			if (piece->alive) {
+				return false;
 			}
-		}
+			delete piece;
+			return true;
+		});
+		pieces->erase(end, pieces->end());
 	}
 }
 
@@ -625,6 +841,9 @@ Piece* Board::getPiece(int pos) {
 Piece* Board::getKing(int color) {
 	return kings[color];
 }
+int Board::getHalfmoveClock() {
+	return halfmoveClock;
+}
 int Board::getEnpassantSquare() {
 	return enpassantSquare;
 }
@@ -643,6 +862,15 @@ int Board::getPieceCount(int color, Piece::PieceType type) {
 int Board::getTotalPieceCount(Piece::PieceType type) {
 	return pieceCount[Color::WHITE][type] + pieceCount[Color::BLACK][type];
 }
+int Board::getMaterial(int color) {
+	return material[color];
+}
+Score Board::getPositionalScore(int color) {
+	return positionalScore[color];
+}
+int Board::getGamePhase() {
+	return gamePhase;
+}
 int Board::getNumberOfMoves() {
 	return hashHistory.size();
 }
@@ -793,4 +1021,25 @@ Piece::PieceType Board::getPieceTypeFromChar(char type)
 
 u64 Board::getHash() {
 	return zobristHasher.getHash();
+}
+
+u64 Board::getPawnHash() {
+	return zobristHasher.getPawnHash();
+}
+
+u64 Board::getMaterialKey() {
+	return materialKey;
+}
+
+MaterialEntry* Board::getMaterialEntry() {
+	return materialTable.probe(this);
+}
+
+void Board::setNNUENetwork(NNUENetwork* network) {
+	nnueNetwork = network;
+	refreshAccumulators();
+}
+
+NNUEAccumulator& Board::getAccumulator() {
+	return accumulators.back();
 }
\ No newline at end of file
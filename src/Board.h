@@ -7,13 +7,22 @@
 #include "Piece.h"
 #include "Color.h"
 #include "ZobristHasher.h"
-#include "AttackMap.h"
+#include "evaluation/Score.h"
+#include "evaluation/NNUE.h"
+#include "evaluation/MaterialTable.h"
 #include "hashing/HashTable.h"
-#include "hashing/AttackMapEntry.h"
 
 class Board
 {
 public:
+	enum GenType {
+		CAPTURES,
+		QUIETS,
+		// pseudo legal moves that may resolve a check, only king moves if not in check
+		EVASIONS,
+		ALL
+	};
+
 	Board();
 	~Board();
 
@@ -26,11 +35,17 @@ public:
 	bool inCheck(int color);
 	bool sufficientMaterial();
 	bool isRepetition();
+	bool isFiftyMoveDraw();
+	// true if the side to move can repeat a position by a reversible move, ply is the distance to the root of the search
+	bool hasUpcomingRepetition(int ply);
 	bool isLegalMove(Move& move);
 	bool isAttackedBy(int square, int color);
+	u64 getPieceAttacks(Piece* piece);
 
 	int generateCaptures(Move * captures);
 	int generateCaptures(int color, Move* captures);
+	int generateQuiets(int color, Move* moves);
+	int generateEvasions(int color, Move* moves);
 	int generateMoves(Move* moves);
 	int generateMoves(int color, Move* moves);
 	void makeMove(Move& move);
@@ -44,13 +59,22 @@ public:
 	void setColorToMove(int c);
 	Piece* getPiece(int pos);
 	Piece* getKing(int color);
+	int getHalfmoveClock();
 	int getEnpassantSquare();
 	Piece* getEnpassantPiece();
 	CastlingRights getCastlingRights();
 	std::vector<Piece*>* getPieceList(int color); 
 	int getPieceCount(int color, Piece::PieceType type);
 	int getTotalPieceCount(Piece::PieceType type);
+	int getMaterial(int color);
+	Score getPositionalScore(int color);
+	int getGamePhase();
 	u64 getHash();
+	u64 getPawnHash();
+	u64 getMaterialKey();
+	MaterialEntry* getMaterialEntry();
+	void setNNUENetwork(NNUENetwork* network);
+	NNUEAccumulator& getAccumulator();
 	int getNumberOfMoves();
 	bool isEmptySquare(int square);
 	bool isSquareOnBoard(int square);
@@ -66,15 +90,43 @@ public:
 	static int convert88To64Square(int square0x88);
 	static int convert64To88Square(int square64);
 private:
+	void computeIncrementalScores();
+	void updateIncrementalScores(Move& move, int sign);
+	void refreshAccumulators();
+
+	template <int color, GenType genType>
+	int generate(Move* moves);
+	template <int color, GenType genType, bool sliding, int numDirections>
+	void generatePieceMoves(Piece* piece, const int (&directions)[numDirections], u64 targets, Move* moves, int& numMoves);
+	template <int color, GenType genType>
+	void generatePawnMoves(Piece* pawn, u64 targets, Move* moves, int& numMoves);
+	template <int color>
+	void generateCastlingMoves(Piece* king, Move* moves, int& numMoves);
+	void addPromotions(int color, Piece* pawn, int dest, Piece* captured, Move* moves, int& numMoves);
+	u64 getEvasionTargets(int color);
+
 	Piece* board[128];
 	int pieceCount[2][6];
 
+	// incrementally updated evaluation terms
+	int material[2];
+	Score positionalScore[2];
+	int gamePhase;
+	// sum of the material keys of all pieces, identifies the piece counts
+	u64 materialKey;
+	MaterialTable materialTable;
+
+	// nnue accumulators, one per made move
+	NNUENetwork* nnueNetwork;
+	std::vector<NNUEAccumulator> accumulators;
+
 	int colorToMove;
-	AttackMap attackMap;
 
 	int enpassantSquare;
 	Piece* enpassantPiece;
 	CastlingRights castlingRights;
+	// plies since the last capture or pawn move
+	int halfmoveClock;
 
 	Piece* kings[2];
 
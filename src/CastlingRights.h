@@ -17,7 +17,7 @@ public:
 			rights |= BLACK_KINGSIDE;
 		}
 		if (blackcanQueenside) {
-			rights |= BLACK_KINGSIDE;
+			rights |= BLACK_QUEENSIDE;
 		}
 	}
 
@@ -78,6 +78,6 @@ private:
 	static const u8 WHITE_KINGSIDE = KINGSIDE;
 	static const u8 WHITE_QUEENSIDE = QUEENSIDE;
 
-	u8 rights; // 0000 kqKQ
+	u8 rights = 0; // 0000 kqKQ
 };
 
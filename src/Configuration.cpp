@@ -40,12 +40,30 @@ reroute:
 		else if (keyValue[0] == "eval-table-size") {
 			evaluationTableSize = std::stoi(keyValue[1]);
 		}
+		else if (keyValue[0] == "pawn-table-size") {
+			pawnTableSize = std::stoi(keyValue[1]);
+		}
 		else if (keyValue[0] == "transposition-table-size") {
 			transpositionTableSize = std::stoi(keyValue[1]);
 		}
 		else if (keyValue[0] == "lua-eval-file") {
 			luaFilename = keyValue[1];
 		}
+		else if (keyValue[0] == "nnue-file") {
+			nnueFilename = keyValue[1];
+		}
+		else if (keyValue[0] == "tablebase-path") {
+			tablebasePath = keyValue[1];
+		}
+		else if (keyValue[0] == "statistics-file") {
+			statisticsFilename = keyValue[1];
+		}
+		else if (keyValue[0] == "log-level") {
+			logLevel = keyValue[1];
+		}
+		else if (keyValue[0] == "log-flush-interval") {
+			logFlushInterval = std::stoi(keyValue[1]);
+		}
 	}
 
 	configFile.close();
@@ -11,5 +11,11 @@ public:
 	std::string path = "./";
 	int transpositionTableSize = 1000001;
 	int evaluationTableSize = 1000001;
+	int pawnTableSize = 100003;
 	std::string luaFilename;
+	std::string nnueFilename;
+	std::string tablebasePath = "tablebases/";
+	std::string statisticsFilename = "statistics.jsonl";
+	std::string logLevel = "debug";
+	int logFlushInterval = 1000;
 };
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include "Piece.h"
+#include "Color.h"
+
+// Table indexed by the difference of two 0x88 squares.
+// Differences range from -119 to 119 and are shifted by DELTA_OFFSET.
+struct DeltaTable
+{
+	static const int DELTA_OFFSET = 119;
+	static const int SIZE = 2 * DELTA_OFFSET + 1;
+
+	int values[SIZE];
+
+	// bit of a piece in the attack table, pawns attack in different directions for both colors
+	static constexpr int attackBit(int color, Piece::PieceType type) {
+		return type == Piece::Pawn && color == Color::BLACK ? 1 << Piece::None : 1 << type;
+	}
+
+	static constexpr int rankDifference(int delta) {
+		return ((delta + 0x77) >> 4) - 7;
+	}
+
+	static constexpr int fileDifference(int delta) {
+		return ((delta + 0x77) & 15) - 7;
+	}
+
+	static constexpr int sign(int x) {
+		return x > 0 ? 1 : x < 0 ? -1 : 0;
+	}
+
+	static constexpr int abs(int x) {
+		return x < 0 ? -x : x;
+	}
+
+	static constexpr DeltaTable generateDirections() {
+		DeltaTable table = {};
+		for (int i = 0; i < SIZE; i++) {
+			int delta = i - DELTA_OFFSET;
+			int dr = rankDifference(delta);
+			int df = fileDifference(delta);
+			if (delta != 0 && (dr == 0 || df == 0 || abs(dr) == abs(df))) {
+				table.values[i] = sign(dr) * 16 + sign(df);
+			}
+		}
+		return table;
+	}
+
+	// pieces which can attack along the difference on an empty board
+	static constexpr DeltaTable generateAttacks() {
+		DeltaTable table = {};
+		for (int i = 0; i < SIZE; i++) {
+			int delta = i - DELTA_OFFSET;
+			int dr = abs(rankDifference(delta));
+			int df = abs(fileDifference(delta));
+			if (delta == 0) {
+				continue;
+			}
+			if (dr <= 1 && df <= 1) {
+				table.values[i] |= attackBit(Color::WHITE, Piece::King);
+			}
+			if ((dr == 1 && df == 2) || (dr == 2 && df == 1)) {
+				table.values[i] |= attackBit(Color::WHITE, Piece::Knight);
+			}
+			if (dr == df) {
+				table.values[i] |= attackBit(Color::WHITE, Piece::Bishop) | attackBit(Color::WHITE, Piece::Queen);
+			}
+			if (dr == 0 || df == 0) {
+				table.values[i] |= attackBit(Color::WHITE, Piece::Rook) | attackBit(Color::WHITE, Piece::Queen);
+			}
+			if (delta == 15 || delta == 17) {
+				table.values[i] |= attackBit(Color::WHITE, Piece::Pawn);
+			}
+			if (delta == -15 || delta == -17) {
+				table.values[i] |= attackBit(Color::BLACK, Piece::Pawn);
+			}
+		}
+		return table;
+	}
+
+	static constexpr DeltaTable generateDistances() {
+		DeltaTable table = {};
+		for (int i = 0; i < SIZE; i++) {
+			int delta = i - DELTA_OFFSET;
+			int dr = abs(rankDifference(delta));
+			int df = abs(fileDifference(delta));
+			table.values[i] = dr > df ? dr : df;
+		}
+		return table;
+	}
+};
+
+static constexpr DeltaTable sDirectionTable = DeltaTable::generateDirections();
+static constexpr DeltaTable sAttackTable = DeltaTable::generateAttacks();
+static constexpr DeltaTable sDistanceTable = DeltaTable::generateDistances();
+
+// lookups for pairs of 0x88 squares, the tables are generated by the compiler
+class DeltaTables
+{
+public:
+	// step from one square towards the other if both are on the same rank, file or diagonal, 0 otherwise
+	static int getDirection(int from, int to) {
+		return sDirectionTable.values[to - from + DeltaTable::DELTA_OFFSET];
+	}
+
+	// true if a piece on the first square could attack the second one on an empty board
+	static bool canAttack(int color, Piece::PieceType type, int from, int to) {
+		return (sAttackTable.values[to - from + DeltaTable::DELTA_OFFSET] & DeltaTable::attackBit(color, type)) != 0;
+	}
+
+	// number of king moves between the squares
+	static int getDistance(int from, int to) {
+		return sDistanceTable.values[to - from + DeltaTable::DELTA_OFFSET];
+	}
+};
@@ -3,6 +3,10 @@
 #include "types.h"
 #include "evaluation/DefaultEvaluator.h"
 #include "evaluation/LuaEvaluator.h"
+#include "evaluation/NNUEEvaluator.h"
+#include "evaluation/KPKBitbase.h"
+#include "tablebase/TablebaseGenerator.h"
+#include "Profiler.h"
 
 #include <string>
 #include <iostream>
@@ -10,17 +14,22 @@
 #include <cctype>
 #include <cstdlib>
 #include <ctime>
+#include <thread>
+#include <algorithm>
+#include <cstring>
 
 Engine::Engine(Configuration* configuration) :
-	searcher(&board, evaluator, &transTable, &log), 
 	transTable(configuration->transpositionTableSize), 
-	log(&board, &transTable, configuration->path + "logs/"), 
+	tablebases(configuration->tablebasePath.empty() ? "" : configuration->path + configuration->tablebasePath),
+	log(&board, configuration->path + "logs/", Log::parseLevel(configuration->logLevel), configuration->logFlushInterval), 
 	clockHandler(&board) {
 
 	this->configuration = configuration;
 	engineName = configuration->engineName;
-	searchDepth = 20;
+	searchDepth = DEFAULT_SEARCH_DEPTH;
 	clockHandler.setMoveTime(10000);
+	KPKBitbase::init();
+	ZobristHasher::initCuckooTables();
 	if (!configuration->luaFilename.empty()) {
 		luaState = luaL_newstate();
 		luaL_openlibs(luaState);
@@ -34,47 +43,131 @@ Engine::Engine(Configuration* configuration) :
 		luaState = nullptr;
 	}
 
-	if (luaState == nullptr) {
-		evaluator = new DefaultEvaluator(&board, configuration->evaluationTableSize);
-		std::cerr << "Using default evaluation..." << std::endl;
-		log.writeMessage("Using default evaluation...");
+	// a network takes precedence over lua and the default evaluation
+	evaluator = nullptr;
+	if (!configuration->nnueFilename.empty()) {
+		NNUENetwork* network = new NNUENetwork();
+		if (network->load(configuration->path + configuration->nnueFilename)) {
+			NNUEEvaluator* nnueEvaluator = new NNUEEvaluator(&board, network, configuration->evaluationTableSize);
+			searcher = new Searcher<NNUEEvaluator>(&board, nnueEvaluator, &transTable, &tablebases, &log);
+			evaluator = nnueEvaluator;
+			std::cerr << "Using nnue evaluation (" << network->getDescription() << ")..." << std::endl;
+			log.writeMessage("Using nnue evaluation...");
+		}
+		else {
+			std::cerr << "Can't load " << configuration->nnueFilename << std::endl;
+			delete network;
+		}
 	}
-	else {
-		evaluator = new LuaEvaluator(&board, luaState, configuration->evaluationTableSize);
-		std::cerr << "Using custom lua evaluation..." << std::endl;
-		log.writeMessage("Using custom lua evaluation...");
+
+	if (evaluator == nullptr) {
+		if (luaState == nullptr) {
+			DefaultEvaluator* defaultEvaluator = new DefaultEvaluator(&board, configuration->evaluationTableSize, configuration->pawnTableSize);
+			searcher = new Searcher<DefaultEvaluator>(&board, defaultEvaluator, &transTable, &tablebases, &log);
+			evaluator = defaultEvaluator;
+			std::cerr << "Using default evaluation..." << std::endl;
+			log.writeMessage("Using default evaluation...");
+		}
+		else {
+			LuaEvaluator* luaEvaluator = new LuaEvaluator(&board, luaState, configuration->evaluationTableSize);
+			searcher = new Searcher<LuaEvaluator>(&board, luaEvaluator, &transTable, &tablebases, &log);
+			evaluator = luaEvaluator;
+			std::cerr << "Using custom lua evaluation..." << std::endl;
+			log.writeMessage("Using custom lua evaluation...");
+		}
+	}
+
+	if (GAUDI_PROFILE) {
+		Profiler::setOutputPath(configuration->path);
+	}
+
+	if (!configuration->statisticsFilename.empty()) {
+		searcher->setStatisticsFile(configuration->path + configuration->statisticsFilename);
 	}
-	searcher.setEvaluator(evaluator);
 }
 
 Engine::~Engine() {
+	delete searcher;
 	if (evaluator != nullptr) {
 		delete evaluator;
 	}
 }
 
-Move Engine::move() {
+Move Engine::move(int timeLimitMs) {
 	board.cleanupDeadPieces();
-	int time = clockHandler.getSearchTime(board.getColorToMove());
+	int time = timeLimitMs > 0 ? timeLimitMs : clockHandler.getSearchTime(board.getColorToMove());
 	log.writeDelimiter();
 	log.getStream() << "Start search with depth " << searchDepth << " and time " << (double)time / 1000.0 << "s" << std::endl;
-	searcher.search(searchDepth, time);
-	Move move = searcher.getBestMove();
-	board.makeMove(move);
+	searcher->search(searchDepth, time);
+	Move move = searcher->getBestMove();
+	// null if the game is over
+	if (move.movingPiece != nullptr) {
+		board.makeMove(move);
+		positionMoves.push_back(move.toString());
+	}
 	return move;
 }
 
+bool Engine::getPonderMove(Move& move) {
+	std::vector<Move> pv = searcher->getPrincipalVariation();
+	if (pv.size() < 2) {
+		return false;
+	}
+	move = pv[1];
+	return true;
+}
+
+void Engine::setInfoCallback(std::function<void(const std::string&)> callback) {
+	searcher->setInfoCallback(callback);
+}
+
+void Engine::setMultiPV(int lines) {
+	searcher->setMultiPV(lines);
+}
+
+void Engine::prepareSearch(int search, bool ponder) {
+	searcher->prepareSearch(search, ponder);
+}
+
+void Engine::stopSearch(int upToSearch) {
+	searcher->stop(upToSearch);
+}
+
+void Engine::ponderHit(int upToSearch) {
+	searcher->ponderHit(upToSearch);
+}
+
 void Engine::startNewGame() {
 	board.loadStartPosition();
+	positionFen.clear();
+	positionMoves.clear();
+	transTable.clear();
 	log.writeMessage("Preparing for new game...");
 	log.writeBoard();
 }
 
 void Engine::setBoard(std::string fen) {
 	board.loadFEN(fen);
+	positionFen = fen;
+	positionMoves.clear();
+}
+
+// GUIs send the whole game with every move, mostly the moves on the board followed by new ones
+void Engine::setPosition(std::string fen, const std::vector<std::string>& moves) {
+	bool extendsBoard = fen == positionFen && moves.size() >= positionMoves.size() && std::equal(positionMoves.begin(), positionMoves.end(), moves.begin());
+	if (!extendsBoard) {
+		setBoard(fen);
+	}
+	for (int i = positionMoves.size(); i < moves.size(); i++) {
+		if (!doMove(moves[i])) {
+			// the board no longer follows the moves, the next position is loaded from scratch
+			positionFen.clear();
+			return;
+		}
+	}
 }
 
-void Engine::doMove(std::string move) {
+bool Engine::doMove(std::string move) {
 	const int rookSquares[2][2] = {
 		{ 0, 7 },
 		{ 112, 119}
@@ -83,7 +176,7 @@ void Engine::doMove(std::string move) {
 	Move m;
 
 	if (move.length() < 4 || !isalpha(move[0]) || !isalpha(move[2]) || !isdigit(move[1]) || !isdigit(move[3])) {
-		return;
+		return false;
 	}
 
 	int k = move[0] - 'a';
@@ -108,6 +201,9 @@ void Engine::doMove(std::string move) {
 	CastlingRights cr = board.getCastlingRights();
 	Piece* srcPiece = board.getPiece(src);
 	Piece* destPiece = board.getPiece(dest);
+	if (srcPiece == nullptr) {
+		return false;
+	}
 
 	// castling
 	if ((move == "e1g1" && king->square == board.getSquareFromString("e1")) || (move == "e8g8" && king->square == board.getSquareFromString("e8"))) {
@@ -134,6 +230,8 @@ void Engine::doMove(std::string move) {
 	}
 
 	board.makeMove(m);
+	positionMoves.push_back(move);
+	return true;
 }
 
 void Engine::playSelf(int clockMode, int time, int increment) {
@@ -229,6 +327,13 @@ void Engine::playSelf(int clockMode, int time, int increment) {
 			}
 			gameOver = true;
 		}
+		else if (board.isFiftyMoveDraw()) {
+			std::string result = "{ 50-move rule } 1/2-1/2";
+			std::cout << result << std::endl;
+			log.getStream() << result << std::endl;
+			pgn.setResult("1/2-1/2");
+			gameOver = true;
+		}
 		else if (board.isRepetition()) {
 			std::string result = "{ 3-time repetition } 1/2-1/2";
 			std::cout << result << std::endl;
@@ -267,6 +372,35 @@ void Engine::setSearchDepth(int depth) {
 	searchDepth = depth;
 }
 
+void Engine::setNodeLimit(u64 nodes) {
+	searcher->setNodeLimit(nodes);
+}
+
+// compares the incrementally updated accumulators with refreshed ones in every position of the tree
+static bool testAccumulators(Board& board, NNUENetwork& network, int depth) {
+	NNUEAccumulator refreshed;
+	network.refreshAccumulator(&board, refreshed, Color::WHITE);
+	network.refreshAccumulator(&board, refreshed, Color::BLACK);
+	if (memcmp(&refreshed, &board.getAccumulator(), sizeof(refreshed)) != 0) {
+		return false;
+	}
+	if (depth == 0) {
+		return true;
+	}
+
+	Move moves[128];
+	int n = board.generateMoves(board.getColorToMove(), moves);
+	bool equal = true;
+	for (int i = 0; i < n && equal; i++) {
+		board.makeMove(moves[i]);
+		if (!board.inCheck(moves[i].color)) {
+			equal = testAccumulators(board, network, depth - 1);
+		}
+		board.unmakeMove(moves[i]);
+	}
+	return equal;
+}
+
 void Engine::runTests() {
 	Move moves[128];
 	int n;
@@ -280,13 +414,19 @@ void Engine::runTests() {
 	for (int i = 0; i < n; i++) {
 		Move& m = moves[i];
 		u64 h = board.getHash();
+		u64 ph = board.getPawnHash();
+		bool pawnMove = m.movingPiece->type == Piece::Pawn || (m.castlingMove == Move::None && m.capturedPiece != nullptr && m.capturedPiece->type == Piece::Pawn);
 		log.getStream() << "Testing move: " << board.getMoveStringAlgebraic(m) << " ...";
 		board.makeMove(m);
 		if (h == board.getHash()) {
 			log.getStream() << "HASH DID NOT CHANGE...";
 		}
+		if (pawnMove == (ph == board.getPawnHash())) {
+			log.getStream() << "PAWN HASH FAIL...";
+			failed = true;
+		}
 		board.unmakeMove(m);
-		if (h != board.getHash()) {
+		if (h != board.getHash() || ph != board.getPawnHash()) {
 			log.getStream() << "HASH FAIL...";
 			failed = true;
 		}
@@ -359,8 +499,46 @@ void Engine::runTests() {
 	std::cout << "Testing move comparison...";
 	log.writeMessage("");
 	log.writeMessage("Testing move comparison...");
-	searcher.test("r1b1kb1r/p3p2p/nq6/1p3pp1/8/5Q1N/PPPP1nPP/RNB1K2R w KQkq - 0 1", 5);
-	if (searcher.getBestMove().source != board.getSquareFromString("f3") || searcher.getBestMove().destination != board.getSquareFromString("a8")) {
+	searcher->test("r1b1kb1r/p3p2p/nq6/1p3pp1/8/5Q1N/PPPP1nPP/RNB1K2R w KQkq - 0 1", 5);
+	if (searcher->getBestMove().source != board.getSquareFromString("f3") || searcher->getBestMove().destination != board.getSquareFromString("a8")) {
+		std::cout << "FAILED" << std::endl;
+	}
+	else {
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	std::cout << "Testing search without legal moves...";
+	log.writeMessage("");
+	log.writeMessage("Testing search without legal moves...");
+	// stalemate and checkmate at the root, the best move stays null
+	failed = false;
+	const std::string gameOverFens[] = { "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", "7k/6Q1/6K1/8/8/8/8/8 b - - 0 1" };
+	for (const std::string& fen : gameOverFens) {
+		searcher->test(fen, 3);
+		if (searcher->getBestMove().movingPiece != nullptr || !searcher->getPrincipalVariation().empty()) {
+			failed = true;
+		}
+	}
+	if (failed) {
+		std::cout << "FAILED" << std::endl;
+	}
+	else {
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	std::cout << "Testing principal variation...";
+	log.writeMessage("");
+	log.writeMessage("Testing principal variation...");
+	// a quiet position searched twice, the second search finds its lines in the table
+	failed = false;
+	const int pvDepth = 6;
+	for (int i = 0; i < 2; i++) {
+		searcher->test("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4", pvDepth);
+		if (searcher->getPrincipalVariation().size() < (size_t)pvDepth) {
+			failed = true;
+		}
+	}
+	if (failed) {
 		std::cout << "FAILED" << std::endl;
 	}
 	else {
@@ -381,6 +559,50 @@ void Engine::runTests() {
 		std::cout << "SUCCESS" << std::endl;
 	}
 
+	std::cout << "Testing tablebase generation...";
+	log.writeMessage("");
+	log.writeMessage("Testing tablebase generation...");
+	TablebaseGenerator generator(std::thread::hardware_concurrency(), false);
+	generator.solveTables("KQvK");
+	generator.solveTables("KRvK");
+	// the longest mates are 10 and 16 moves, with the losing side to move
+	log.getStream() << "Longest mates: KQvK " << generator.getLongestMate("KQvK") << " plies, should be 20, KRvK " <<
+		generator.getLongestMate("KRvK") << " plies, should be 32" << std::endl;
+	if (generator.getLongestMate("KQvK") != 20 || generator.getLongestMate("KRvK") != 32) {
+		std::cout << "FAILED" << std::endl;
+	}
+	else {
+		std::cout << "SUCCESS" << std::endl;
+	}
+
+	std::cout << "Testing nnue accumulators...";
+	log.writeMessage("");
+	log.writeMessage("Testing nnue accumulators...");
+	// castling, captures, promotions and en passant, the moves of all positions are made on a separate board
+	const std::string accumulatorFens[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+	};
+	NNUENetwork network;
+	network.initRandom(1);
+	Board nnueBoard;
+	nnueBoard.setNNUENetwork(&network);
+	failed = false;
+	for (const std::string& fen : accumulatorFens) {
+		nnueBoard.loadFEN(fen);
+		if (!testAccumulators(nnueBoard, network, 3)) {
+			log.getStream() << "Accumulators differ from a refresh below " << fen << std::endl;
+			failed = true;
+		}
+	}
+	if (failed) {
+		std::cout << "FAILED" << std::endl;
+	}
+	else {
+		std::cout << "SUCCESS" << std::endl;
+	}
+
 }
 
 void Engine::evaluatePosition(std::string fen) {
@@ -398,6 +620,11 @@ void Engine::evaluatePosition(std::string fen) {
 	std::cout << "Evaluation score: " << (double)score / 100.0 << std::endl;
 }
 
+void Engine::generateTablebase(std::string name) {
+	TablebaseGenerator generator(std::thread::hardware_concurrency());
+	generator.generate(name, configuration->path + configuration->tablebasePath);
+}
+
 void Engine::showBoardDebug() {
 	std::cout << "-- Board Debug Info ------------------------" << std::endl;
 	std::cout << "Castling rights: " << board.getCastlingRights().getString() << std::endl;
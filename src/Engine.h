@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <functional>
+#include <vector>
 
 #include <lua.hpp>
 
@@ -14,31 +16,49 @@
 #include "hashing/HashTable.h"
 #include "hashing/TranspositionEntry.h"
 #include "evaluation/Evaluator.h"
+#include "tablebase/Tablebases.h"
 
 class Engine
 {
 public:
+	static const int DEFAULT_SEARCH_DEPTH = 20;
+
 	std::string engineName;
 
 	Engine(Configuration* configuration);
 	~Engine();
-	Move move();
+	// the time limit only holds for this search, 0 searches by the clock
+	Move move(int timeLimitMs = 0);
+	// the expected answer to the last move of the engine
+	bool getPonderMove(Move& move);
+	void setInfoCallback(std::function<void(const std::string&)> callback);
+	void setMultiPV(int lines);
+	// see SearcherBase, stopSearch and ponderHit are thread safe
+	void prepareSearch(int search, bool ponder);
+	void stopSearch(int upToSearch);
+	void ponderHit(int upToSearch);
 	void startNewGame();
 	void setBoard(std::string fen);
-	void doMove(std::string move);
+	// only plays the new moves if the moves continue the game on the board
+	void setPosition(std::string fen, const std::vector<std::string>& moves);
+	bool doMove(std::string move);
 	void playSelf(int clockMode = ClockHandler::MOVETIME, int time = 1000, int increment = 0);
 	Log* getLog();
 	void setClockTime(int color, int timeMs);
 	void setClockIncrement(int color, int timeMs);
 	void setMoveTime(int timeMs);
 	void setSearchDepth(int depth);
+	// 0 searches by the clock
+	void setNodeLimit(u64 nodes);
 	void runTests();
 	void evaluatePosition(std::string fen);
+	void generateTablebase(std::string name);
 	void showBoardDebug();
 private:
 	Board board;
-	Searcher searcher;
+	SearcherBase* searcher;
 	HashTable<TranspositionEntry> transTable;
+	Tablebases tablebases;
 	ClockHandler clockHandler;
 	Log log;
 	PGN pgn;
@@ -46,5 +66,8 @@ private:
 	Configuration* configuration;
 	lua_State* luaState;
 	int searchDepth;
+	// the position the moves on the board were played from, and the moves
+	std::string positionFen;
+	std::vector<std::string> positionMoves;
 };
 
@@ -3,6 +3,10 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+#include <cerrno>
 
 class Helpers {
 public:
@@ -13,7 +17,7 @@ public:
 
 		str.erase(new_end, str.end());
 
-		while (str[str.length() - 1] == delimiter) {
+		while (!str.empty() && str[str.length() - 1] == delimiter) {
 			str.pop_back();
 		}
 
@@ -33,4 +37,25 @@ public:
 
 		return splits;
 	}
+
+	// false if the string is not a whole number in the range of int
+	static bool parseInt(const std::string& str, int& value) {
+		if (str.empty()) {
+			return false;
+		}
+		char* end;
+		errno = 0;
+		long result = std::strtol(str.c_str(), &end, 10);
+		if (*end != '\0' || errno == ERANGE || result < INT_MIN || result > INT_MAX) {
+			return false;
+		}
+		value = (int)result;
+		return true;
+	}
+
+	static bool equalsIgnoreCase(const std::string& a, const std::string& b) {
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+			return std::tolower((unsigned char)x) == std::tolower((unsigned char)y);
+		});
+	}
 };
\ No newline at end of file
@@ -4,53 +4,100 @@
 #include <sstream>
 #include <ctime>
 
-Log::Log(Board* board, HashTable<TranspositionEntry>* transTable, std::string path) {
-	this->board = board;
-	this->transTable = transTable;
+static std::string getFilename(std::string path) {
 	std::time_t now = std::time(nullptr);
 	tm* localTime = localtime(&now);
 	std::stringstream ss;
 	ss << path << "log_" << 1900 + localTime->tm_year << "-" << 1 + localTime->tm_mon << "-" 
 	   << localTime->tm_mday << "_" << localTime->tm_hour << "-" 
 	   << localTime->tm_min << "-" << localTime->tm_sec << ".txt";
-	logFile.open(ss.str());
+	return ss.str();
+}
+
+Log::LineBuffer::LineBuffer(AsyncLogger* logger) {
+	this->logger = logger;
 }
 
-Log::~Log() {
-	if (logFile.is_open()) {
-		logFile.close();
+// a line without newline is still written
+Log::LineBuffer::~LineBuffer() {
+	if (!line.empty()) {
+		logger->push(std::move(line));
 	}
 }
 
-void Log::writeDelimiter() {
-	logFile << "-------------------------------------------------------------" << std::endl;
+int Log::LineBuffer::overflow(int c) {
+	if (c == '\n') {
+		logger->push(std::move(line));
+		line.clear();
+	}
+	else if (c != traits_type::eof()) {
+		line += (char)c;
+	}
+	return traits_type::not_eof(c);
 }
 
-void Log::writePV() {
-	logFile << "PV: ";
-	writePVInternal();
-	logFile << std::endl;
+std::streamsize Log::LineBuffer::xsputn(const char* s, std::streamsize n) {
+	for (std::streamsize i = 0; i < n; i++) {
+		overflow(s[i]);
+	}
+	return n;
+}
+
+Log::Log(Board* board, std::string path, Level level, int flushIntervalMs) :
+	logger(level == Off ? "" : getFilename(path), flushIntervalMs),
+	buffer(&logger),
+	logStream(&buffer),
+	nullStream(nullptr) {
+	this->board = board;
+	this->level = logger.isOpen() ? level : Off;
 }
 
-void Log::writePVInternal() {
-	TranspositionEntry* e = transTable->find(board->getHash());
-	if (e->hash == board->getHash() && e->flag == TranspositionEntry::HASH_EXACT) {
-		logFile << board->getMoveStringAlgebraic(e->bestMove) << " ";
-		board->makeMove(e->bestMove);
-		if (!board->isRepetition()) {
-			writePVInternal();
-		}
-		board->unmakeMove(e->bestMove);
+void Log::writeDelimiter() {
+	getStream() << "-------------------------------------------------------------" << std::endl;
+}
+
+void Log::writePV(const std::vector<Move>& pv) {
+	std::ostream& stream = getStream();
+	stream << "PV: ";
+	for (int i = 0; i < pv.size(); i++) {
+		Move move = pv[i];
+		stream << move.toString() << " ";
 	}
+	stream << std::endl;
 }
 
 void Log::writeBoard() {
-	board->print(logFile);
+	if (level <= Info) {
+		board->print(logStream);
+	}
+}
+
+void Log::writeMessage(std::string str, Level level) {
+	if (level >= this->level) {
+		logger.push(str);
+	}
 }
-void Log::writeMessage(std::string str) {
-	logFile << str << std::endl;
+
+std::ostream& Log::getStream(Level level) {
+	return level >= this->level ? logStream : nullStream;
 }
 
-std::ostream& Log::getStream() {
-	return logFile;
+Log::Level Log::parseLevel(std::string name) {
+	if (name == "debug") {
+		return Debug;
+	}
+	else if (name == "info") {
+		return Info;
+	}
+	else if (name == "warning") {
+		return Warning;
+	}
+	else if (name == "error") {
+		return Error;
+	}
+	else if (name == "off") {
+		return Off;
+	}
+	std::cerr << "Unknown log level '" << name << "'" << std::endl;
+	return Debug;
 }
\ No newline at end of file
@@ -1,25 +1,55 @@
 #pragma once
 
-#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
 #include "Board.h"
-#include "hashing/HashTable.h"
-#include "hashing/TranspositionEntry.h"
+#include "AsyncLogger.h"
 
 class Log
 {
 public:
-	Log(Board* board, HashTable<TranspositionEntry>* transTable, std::string path = "./");
-	~Log();
+	enum Level {
+		Debug,
+		Info,
+		Warning,
+		Error,
+		Off
+	};
+
+	// flushIntervalMs as in AsyncLogger
+	Log(Board* board, std::string path = "./", Level level = Debug, int flushIntervalMs = 1000);
 	void writeDelimiter();
-	void writePV();
+	void writePV(const std::vector<Move>& pv);
 	void writeBoard();
-	void writeMessage(std::string str);
-	std::ostream & getStream();
+	// may be called from any thread
+	void writeMessage(std::string str, Level level = Info);
+	// the stream is not synchronized, only the search thread writes to it
+	std::ostream & getStream(Level level = Info);
+
+	// "debug", "info", "warning", "error" or "off"
+	static Level parseLevel(std::string name);
 private:
-	void writePVInternal();
+	// collects the characters of the current line, completed lines go to the logger
+	class LineBuffer : public std::streambuf
+	{
+	public:
+		LineBuffer(AsyncLogger* logger);
+		~LineBuffer();
+	protected:
+		int overflow(int c);
+		std::streamsize xsputn(const char* s, std::streamsize n);
+	private:
+		AsyncLogger* logger;
+		std::string line;
+	};
 
-	std::ofstream logFile;
+	AsyncLogger logger;
+	LineBuffer buffer;
+	std::ostream logStream;
+	// discards everything, returned for suppressed levels
+	std::ostream nullStream;
+	Level level;
 	Board* board;
-	HashTable<TranspositionEntry>* transTable;
 };
 
@@ -1,6 +1,7 @@
 #include "Move.h"
 #include "Board.h"
 #include <cctype>
+#include <cstdio>
 
 // normal move
 Move::Move(int color, int source, int destination, Piece* movingPiece, Piece* capturedPiece, int oldEnpassantSquare, Piece* oldEnpassantPiece, CastlingRights oldCastlingRights) {
@@ -67,7 +68,10 @@ Move::Move(int color, int source, int destination, Piece* movingPiece, Piece* ca
 }
 
 std::string Move::toString() {
-	if (castlingMove == Kingside && color == Color::BLACK)
+	// the null move of the protocol, e.g. the best move of a mated side
+	if (movingPiece == nullptr)
+		return "0000";
+	else if (castlingMove == Kingside && color == Color::BLACK)
 		return "e8g8";
 	else if (castlingMove == Kingside && color == Color::WHITE)
 		return "e1g1";
@@ -77,12 +81,12 @@ std::string Move::toString() {
 		return "e1c1";
 	else if (promotionType != Piece::None) {
 		char buff[32];
-		sprintf_s(buff, "%c%c%c%c%c", Board::getFileBySquare(source), Board::getRankBySquare(source), Board::getFileBySquare(destination), Board::getRankBySquare(destination), tolower(Board::getCharOfPiece(promotionType)));
+		snprintf(buff, sizeof(buff), "%c%c%c%c%c", Board::getFileBySquare(source), Board::getRankBySquare(source), Board::getFileBySquare(destination), Board::getRankBySquare(destination), tolower(Board::getCharOfPiece(promotionType)));
 		return std::string(buff);
 	}
 	else {
 		char buff[32];
-		sprintf_s(buff, "%c%c%c%c", Board::getFileBySquare(source), Board::getRankBySquare(source), Board::getFileBySquare(destination), Board::getRankBySquare(destination));
+		snprintf(buff, sizeof(buff), "%c%c%c%c", Board::getFileBySquare(source), Board::getRankBySquare(source), Board::getFileBySquare(destination), Board::getRankBySquare(destination));
 		return std::string(buff);
 	}
 }
@@ -41,6 +41,7 @@ public:
 	Piece::PieceType promotionType;
 	CastlingMove castlingMove;
 	CastlingRights oldCastlingRights;
+	int oldHalfmoveClock;
 
 	Piece* movingPiece;
 	Piece* capturedPiece;
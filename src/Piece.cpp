@@ -1,13 +1,13 @@
 #include "Piece.h"
 #include "Board.h"
 
-static int sWhitePawnVectorTable[] = { 16 };
-static int sBlackPawnVectorTable[] = { -16 };
-static int sKnightVectorTable[] = { 14,18,-14,-18,31,33,-31,-33 };
-static int sKingVectorTable[] = { 1,17,16,15,-1,-17,-16,-15 };
-static int sBishopVectorTable[] = { 17,15,-17,-15 };
-static int sRookVectorTable[] = { 16,1,-16,-1 };
-static int sQueenVectorTable[] = { 1,17,16,15,-1,-17,-16,-15 };
+static constexpr int sWhitePawnVectorTable[] = { 16 };
+static constexpr int sBlackPawnVectorTable[] = { -16 };
+
+constexpr int Piece::KNIGHT_VECTORS[8];
+constexpr int Piece::KING_VECTORS[8];
+constexpr int Piece::BISHOP_VECTORS[4];
+constexpr int Piece::ROOK_VECTORS[4];
 
 Piece::Piece(int color, PieceType type, int square, bool isKingsideRook=false, bool isQueensideRook=false) {
 	this->color = color;
@@ -71,23 +71,23 @@ void Piece::setupVectorMoves() {
 		numVectorMoves = 1;
 		break;
 	case Knight:
-		vectorMoves = sKnightVectorTable;
+		vectorMoves = KNIGHT_VECTORS;
 		numVectorMoves = 8;
 		break;
 	case King:
-		vectorMoves = sKingVectorTable;
+		vectorMoves = KING_VECTORS;
 		numVectorMoves = 8;
 		break;
 	case Bishop:
-		vectorMoves = sBishopVectorTable;
+		vectorMoves = BISHOP_VECTORS;
 		numVectorMoves = 4;
 		break;
 	case Rook:
-		vectorMoves = sRookVectorTable;
+		vectorMoves = ROOK_VECTORS;
 		numVectorMoves = 4;
 		break;
 	case Queen:
-		vectorMoves = sQueenVectorTable;
+		vectorMoves = KING_VECTORS;
 		numVectorMoves = 8;
 		break;
 	}
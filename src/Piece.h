@@ -16,6 +16,12 @@ public:
 		None
 	};
 
+	// 0x88 offsets of the moves of each piece type, the queen slides along the king vectors
+	static constexpr int KNIGHT_VECTORS[8] = { 14,18,-14,-18,31,33,-31,-33 };
+	static constexpr int KING_VECTORS[8] = { 1,17,16,15,-1,-17,-16,-15 };
+	static constexpr int BISHOP_VECTORS[4] = { 17,15,-17,-15 };
+	static constexpr int ROOK_VECTORS[4] = { 16,1,-16,-1 };
+
 	Piece(int color, PieceType type, int square, bool isKingsideRook, bool isQueensideRook);
 	~Piece();
 
@@ -31,7 +37,7 @@ public:
 	bool hasMoved;
 	bool isKingsideRook;
 	bool isQueensideRook;
-	int* vectorMoves;
+	const int* vectorMoves;
 	int numVectorMoves;
 	bool alive;
 };
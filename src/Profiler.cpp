@@ -0,0 +1,164 @@
+#include "Profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <ctime>
+
+#if GAUDI_PROFILE_PERF && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#define PROFILER_HAS_PERF true
+#else
+#define PROFILER_HAS_PERF false
+#endif
+
+u64 Profiler::phaseCycles[PHASES];
+u64 Profiler::phaseCalls[PHASES];
+ProfileScope* ProfileScope::active = nullptr;
+
+static const char* sPhaseNames[Profiler::PHASES] = { "search", "quiesce", "movegen", "ordering", "eval", "ttprobe", "make", "unmake" };
+
+// hardware counters read at the iteration boundaries
+static const int PERF_COUNTERS = 4;
+static const char* sPerfNames[PERF_COUNTERS] = { "instructions", "cpuCycles", "cacheMisses", "branchMisses" };
+
+static std::string sOutputPrefix = "trace_";
+static int sSearchNumber = 0;
+static std::chrono::steady_clock::time_point sSearchBegin;
+static std::chrono::steady_clock::time_point sIterationBegin;
+static u64 sIterationCycles[Profiler::PHASES];
+static u64 sIterationCalls[Profiler::PHASES];
+static u64 sIterationPerf[PERF_COUNTERS];
+static std::vector<std::string> sEvents;
+#if PROFILER_HAS_PERF
+static int sPerfFds[PERF_COUNTERS] = { -1, -1, -1, -1 };
+#endif
+
+static long long microseconds(std::chrono::steady_clock::time_point time) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(time - sSearchBegin).count();
+}
+
+static bool readPerfCounters(u64 values[PERF_COUNTERS]) {
+#if PROFILER_HAS_PERF
+	static bool opened = false;
+	if (!opened) {
+		opened = true;
+		const u64 configs[PERF_COUNTERS] = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+		for (int i = 0; i < PERF_COUNTERS; i++) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = configs[i];
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			sPerfFds[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+			if (sPerfFds[i] < 0) {
+				std::cerr << "Can't open perf counter " << sPerfNames[i] << ", check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+			}
+		}
+	}
+
+	bool any = false;
+	for (int i = 0; i < PERF_COUNTERS; i++) {
+		values[i] = 0;
+		if (sPerfFds[i] >= 0 && read(sPerfFds[i], &values[i], sizeof(u64)) == sizeof(u64)) {
+			any = true;
+		}
+	}
+	return any;
+#else
+	(void)values;
+	return false;
+#endif
+}
+
+// cycles and calls of all phases since the snapshot
+static void writePhases(std::ostream& stream, const u64 cycles[], const u64 calls[], const u64 sinceCycles[], const u64 sinceCalls[]) {
+	for (int i = 0; i < Profiler::PHASES; i++) {
+		stream << (i > 0 ? "," : "") << "\"" << sPhaseNames[i] << "\":{\"cycles\":" << cycles[i] - sinceCycles[i] << ",\"calls\":" << calls[i] - sinceCalls[i] << "}";
+	}
+}
+
+void Profiler::setOutputPath(std::string path) {
+	std::time_t now = std::time(nullptr);
+	tm* localTime = localtime(&now);
+	std::stringstream ss;
+	ss << path << "trace_" << 1900 + localTime->tm_year << "-" << 1 + localTime->tm_mon << "-"
+	   << localTime->tm_mday << "_" << localTime->tm_hour << "-"
+	   << localTime->tm_min << "-" << localTime->tm_sec << "_";
+	sOutputPrefix = ss.str();
+}
+
+void Profiler::beginSearch() {
+	for (int i = 0; i < PHASES; i++) {
+		phaseCycles[i] = 0;
+		phaseCalls[i] = 0;
+	}
+	sEvents.clear();
+	sEvents.push_back("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"search\"}}");
+	sSearchBegin = std::chrono::steady_clock::now();
+}
+
+void Profiler::endSearch() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const u64 zero[PHASES] = {};
+	std::stringstream event;
+	event << "{\"name\":\"search\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":0,\"dur\":" << microseconds(now) << ",\"args\":{";
+	writePhases(event, phaseCycles, phaseCalls, zero, zero);
+	event << "}}";
+	sEvents.push_back(event.str());
+
+	std::string filename = sOutputPrefix + std::to_string(++sSearchNumber) + ".json";
+	std::ofstream file(filename);
+	if (!file.is_open()) {
+		std::cerr << "Trace file '" << filename << "' could not be opened!" << std::endl;
+		return;
+	}
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+	for (int i = 0; i < sEvents.size(); i++) {
+		file << sEvents[i] << (i + 1 < sEvents.size() ? "," : "") << std::endl;
+	}
+	file << "]}" << std::endl;
+}
+
+void Profiler::beginIteration() {
+	for (int i = 0; i < PHASES; i++) {
+		sIterationCycles[i] = phaseCycles[i];
+		sIterationCalls[i] = phaseCalls[i];
+	}
+	readPerfCounters(sIterationPerf);
+	sIterationBegin = std::chrono::steady_clock::now();
+}
+
+void Profiler::endIteration(int depth, bool completed) {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	u64 perf[PERF_COUNTERS];
+	bool hasPerf = readPerfCounters(perf);
+
+	// a slice per iteration with its phases and counters
+	std::stringstream event;
+	event << "{\"name\":\"depth " << depth << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << microseconds(sIterationBegin) <<
+		",\"dur\":" << microseconds(now) - microseconds(sIterationBegin) << ",\"args\":{\"completed\":" << (completed ? "true" : "false") << ",";
+	writePhases(event, phaseCycles, phaseCalls, sIterationCycles, sIterationCalls);
+	if (hasPerf) {
+		for (int i = 0; i < PERF_COUNTERS; i++) {
+			event << ",\"" << sPerfNames[i] << "\":" << perf[i] - sIterationPerf[i];
+		}
+	}
+	event << "}}";
+	sEvents.push_back(event.str());
+
+	// the cycles of the iteration by phase, shown as stacked counter
+	std::stringstream counter;
+	counter << "{\"name\":\"cycles\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":" << microseconds(sIterationBegin) << ",\"args\":{";
+	for (int i = 0; i < PHASES; i++) {
+		counter << (i > 0 ? "," : "") << "\"" << sPhaseNames[i] << "\":" << phaseCycles[i] - sIterationCycles[i];
+	}
+	counter << "}}";
+	sEvents.push_back(counter.str());
+}
\ No newline at end of file
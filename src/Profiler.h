@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "types.h"
+
+// time the phases of the search, off unless built with GAUDI_PROFILE
+#ifndef GAUDI_PROFILE
+#define GAUDI_PROFILE false
+#endif
+
+// read cache and branch misses per iteration with perf_event_open, linux only
+#ifndef GAUDI_PROFILE_PERF
+#define GAUDI_PROFILE_PERF false
+#endif
+
+// Cycle counts of the search phases, written as a chrome trace (chrome://tracing, ui.perfetto.dev) after every search.
+// A phase only counts its own cycles, nested phases are subtracted.
+class Profiler
+{
+public:
+	enum Phase {
+		Search,
+		Quiesce,
+		MoveGeneration,
+		MoveOrdering,
+		Evaluation,
+		TableProbe,
+		MakeMove,
+		UnmakeMove,
+		PHASES
+	};
+
+	// traces are written to the path, named by the start time of the engine and the number of the search
+	static void setOutputPath(std::string path);
+	static void beginSearch();
+	static void endSearch();
+	static void beginIteration();
+	static void endIteration(int depth, bool completed);
+
+	// time stamp counter, nanoseconds where there is none
+	static u64 readCycles() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	static void addCycles(Phase phase, u64 cycles) {
+		phaseCycles[phase] += cycles;
+		phaseCalls[phase]++;
+	}
+private:
+	static u64 phaseCycles[PHASES];
+	static u64 phaseCalls[PHASES];
+};
+
+// Adds the cycles from construction to destruction to the phase, without the cycles of scopes opened meanwhile.
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler::Phase phase) {
+		this->phase = phase;
+		parent = active;
+		active = this;
+		childCycles = 0;
+		start = Profiler::readCycles();
+	}
+
+	~ProfileScope() {
+		u64 cycles = Profiler::readCycles() - start;
+		Profiler::addCycles(phase, cycles - childCycles);
+		if (parent != nullptr) {
+			parent->childCycles += cycles;
+		}
+		active = parent;
+	}
+private:
+	static ProfileScope* active;
+
+	Profiler::Phase phase;
+	ProfileScope* parent;
+	u64 start;
+	u64 childCycles;
+};
+
+#if GAUDI_PROFILE
+#define PROFILE_SCOPE(phase) ProfileScope profileScope(Profiler::phase)
+#else
+#define PROFILE_SCOPE(phase)
+#endif
+
@@ -0,0 +1,82 @@
+#include "SearchStatistics.h"
+
+#include <algorithm>
+#include <cstring>
+
+static double ratio(u64 part, u64 whole) {
+	return whole == 0 ? 0.0 : (double)part / (double)whole;
+}
+
+void SearchStatistics::reset() {
+	table = TableCounters();
+	quiesceTable = TableCounters();
+	evaluations = 0;
+	tablebaseHits = 0;
+	quiesceCutoffs = 0;
+	standPatCuts = 0;
+	futilityPrunes = 0;
+	deltaPrunes = 0;
+	iterations.clear();
+	std::memset(depths, 0, sizeof(depths));
+}
+
+void SearchStatistics::addIteration(u64 nodes) {
+	iterations.push_back(nodes);
+}
+
+SearchStatistics::DepthCounters& SearchStatistics::atDepth(int depth) {
+	return depths[std::min(depth, MAX_DEPTH - 1)];
+}
+
+void SearchStatistics::writeJSON(std::ostream& stream, u64 hash, int depth, int selDepth, int timeMs, u64 nodes, u64 quiesceNodes) {
+	u64 allNodes = nodes + quiesceNodes;
+	u64 cutoffs = 0;
+	u64 firstMoveCutoffs = 0;
+	for (int i = 0; i < MAX_DEPTH; i++) {
+		cutoffs += depths[i].cutoffs;
+		firstMoveCutoffs += depths[i].firstMoveCutoffs;
+	}
+
+	stream << "{\"hash\":\"" << std::hex << hash << std::dec << "\",\"depth\":" << depth << ",\"seldepth\":" << selDepth << ",\"timeMs\":" << timeMs <<
+		",\"nodes\":" << allNodes << ",\"searchNodes\":" << nodes << ",\"quiesceNodes\":" << quiesceNodes <<
+		",\"quiesceShare\":" << ratio(quiesceNodes, allNodes) << ",\"evaluations\":" << evaluations <<
+		",\"tablebaseHits\":" << tablebaseHits <<
+		",\"cutoffs\":" << cutoffs << ",\"firstMoveCutoffRate\":" << ratio(firstMoveCutoffs, cutoffs);
+
+	// nodes of each iteration and the ratio to the previous one
+	stream << ",\"iterations\":[";
+	for (int i = 0; i < iterations.size(); i++) {
+		u64 iterationNodes = iterations[i] - (i > 0 ? iterations[i - 1] : 0);
+		u64 previousNodes = i > 1 ? iterations[i - 1] - iterations[i - 2] : (i == 1 ? iterations[0] : 0);
+		stream << (i > 0 ? "," : "") << "{\"depth\":" << i + 1 << ",\"nodes\":" << iterationNodes <<
+			",\"branchingFactor\":" << ratio(iterationNodes, previousNodes) << "}";
+	}
+	stream << "]";
+
+	stream << ",\"table\":";
+	writeTable(stream, table);
+	stream << ",\"quiesceTable\":";
+	writeTable(stream, quiesceTable);
+
+	stream << ",\"quiesce\":{\"cutoffs\":" << quiesceCutoffs << ",\"standPatCuts\":" << standPatCuts <<
+		",\"futilityPrunes\":" << futilityPrunes << ",\"deltaPrunes\":" << deltaPrunes << "}";
+
+	stream << ",\"byDepth\":[";
+	bool first = true;
+	for (int i = 0; i < MAX_DEPTH; i++) {
+		DepthCounters& counters = depths[i];
+		if (counters.nodes == 0 && counters.tableCuts == 0) {
+			continue;
+		}
+		stream << (first ? "" : ",") << "{\"depth\":" << i << ",\"nodes\":" << counters.nodes << ",\"cutoffs\":" << counters.cutoffs <<
+			",\"firstMoveCutoffRate\":" << ratio(counters.firstMoveCutoffs, counters.cutoffs) << ",\"tableCuts\":" << counters.tableCuts << "}";
+		first = false;
+	}
+	stream << "]}" << std::endl;
+}
+
+void SearchStatistics::writeTable(std::ostream& stream, const TableCounters& counters) {
+	stream << "{\"probes\":" << counters.probes << ",\"hits\":" << counters.hits << ",\"cuts\":" << counters.cuts <<
+		",\"collisions\":" << counters.collisions << ",\"hitRate\":" << ratio(counters.hits, counters.probes) <<
+		",\"cutRate\":" << ratio(counters.cuts, counters.probes) << ",\"collisionRate\":" << ratio(counters.collisions, counters.probes) << "}";
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "types.h"
+
+// Counters of a single search, filled by searchers built with GAUDI_SEARCH_STATISTICS.
+class SearchStatistics
+{
+public:
+	static const int MAX_DEPTH = 128;
+
+	// counters of the nodes with the same remaining depth
+	struct DepthCounters
+	{
+		u64 nodes;
+		u64 cutoffs;
+		u64 firstMoveCutoffs;
+		u64 tableCuts;
+	};
+
+	// probes of the transposition table, a collision is a slot used by another position
+	struct TableCounters
+	{
+		u64 probes;
+		u64 hits;
+		u64 cuts;
+		u64 collisions;
+	};
+
+	void reset();
+	// total nodes after each completed iteration
+	void addIteration(u64 nodes);
+	DepthCounters& atDepth(int depth);
+
+	// one json object on a single line
+	void writeJSON(std::ostream& stream, u64 hash, int depth, int selDepth, int timeMs, u64 nodes, u64 quiesceNodes);
+
+	TableCounters table;
+	TableCounters quiesceTable;
+	u64 evaluations;
+	u64 tablebaseHits;
+	u64 quiesceCutoffs;
+	u64 standPatCuts;
+	// stand pattern plus a queen is below alpha
+	u64 futilityPrunes;
+	// captures which can not raise alpha
+	u64 deltaPrunes;
+private:
+	void writeTable(std::ostream& stream, const TableCounters& counters);
+
+	std::vector<u64> iterations;
+	DepthCounters depths[MAX_DEPTH];
+};
+
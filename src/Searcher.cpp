@@ -1,43 +1,63 @@
 #include "Searcher.h"
 #include "evaluation/DefaultEvaluator.h"
+#include "evaluation/LuaEvaluator.h"
+#include "evaluation/NNUEEvaluator.h"
+#include "evaluation/Endgame.h"
+#include "Profiler.h"
 
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <cstdlib>
+#include <string>
 #include <algorithm>
 
-Searcher::Searcher(Board* board, Evaluator* evaluator, HashTable<TranspositionEntry>* transTable, Log* log) : moveComparator(board, transTable) {
+template <class EvaluatorT, bool Statistics>
+Searcher<EvaluatorT, Statistics>::Searcher(Board* board, EvaluatorT* evaluator, HashTable<TranspositionEntry>* transTable, Tablebases* tablebases, Log* log) : moveComparator(board, transTable) {
 	this->board = board;
 	this->evaluator = evaluator;
 	this->transTable = transTable;
+	this->tablebases = tablebases;
 	this->log = log;
 }
 
-void Searcher::search(int depth, int timeLimitMs) {
-	int d = 2;
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::search(int depth, int timeLimitMs) {
+	int d = 1;
 	int score = 0;
 	timeUp = false;
 
 	timeLimit = timeLimitMs;
+	rootPly = board->getNumberOfMoves();
+	selDepth = 0;
 	nodes = 0;
 	quiesceNodes = 0;
-	tableHits = 0;
-	quiesceTableHits = 0; 
-	evaluations = 0;
+	if (Statistics) {
+		statistics.reset();
+	}
 
 	beginSearch = std::chrono::steady_clock::now();
 	std::chrono::steady_clock::time_point lastSearch = beginSearch;
 	int prevScore = 0;
+	if (GAUDI_PROFILE) {
+		Profiler::beginSearch();
+	}
 	while (d <= depth) {
 		prevScore = score;
+		if (GAUDI_PROFILE) {
+			Profiler::beginIteration();
+		}
 		score = pvSearchRoot(d);
+		if (GAUDI_PROFILE) {
+			Profiler::endIteration(d, !timeUp);
+		}
 
 		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 		int timeLeft = timeLimit - std::chrono::duration_cast<std::chrono::milliseconds>(now - beginSearch).count();
 		int lastIterationTime = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastSearch).count();
 		int nextIterationEstimate = lastIterationTime * 3; //d;
 		if (timeUp) {
-			if (d == 2) {
+			if (d == 1) {
 				log->writeMessage("Exiting in first iteration. Choosing random move...");
 			}
 			else {
@@ -46,7 +66,11 @@ void Searcher::search(int depth, int timeLimitMs) {
 			}
 			break;
 		}
-		if (nextIterationEstimate > timeLeft) {
+		if (Statistics) {
+			statistics.addIteration((u64)nodes + quiesceNodes);
+		}
+		sendInfo(d);
+		if (nodeLimit == 0 && !isPondering() && nextIterationEstimate > timeLeft) {
 			log->getStream() << "Exiting search: depth = " << d <<
 				", last iteration time = " << (double)lastIterationTime / 1000.0 <<
 				"s, estimated next iteration time = " << (double)nextIterationEstimate / 1000.0 <<
@@ -56,110 +80,207 @@ void Searcher::search(int depth, int timeLimitMs) {
 
 		d++;
 	}
+	if (GAUDI_PROFILE) {
+		Profiler::endSearch();
+	}
 	int allNodes = quiesceNodes + nodes;
-	int allTableHits = tableHits + quiesceTableHits;
 	log->getStream() << "Searching depth: " << d << std::endl;
 	log->getStream() << "Search Nodes : " << nodes << "(" << (double)nodes/(double)allNodes * 100.0 << "%)" <<
 		", Quiescence Nodes: " << quiesceNodes << "(" << (double)quiesceNodes / (double)allNodes * 100.0 << "%)" <<
 		", Nodes: " << allNodes << std::endl;
-	log->getStream() << "Search Table Hits : " << tableHits << "(" << (double)tableHits / (double)allTableHits * 100.0 << "%)" <<
-		", Quiescent Table Hits: " << quiesceTableHits << "(" << (double)quiesceTableHits / (double)allTableHits * 100.0 << "%)" <<
-		", Table Hits: " << allTableHits << std::endl;
-	log->getStream() << "Evaluations: " << evaluations << std::endl;
-	log->getStream() << "Best move: " << board->getMoveStringAlgebraic(bestMove) << " , score: " << (float)score / 100.0f << std::endl;
-	log->writePV();
+	if (Statistics) {
+		u64 tableHits = statistics.table.cuts;
+		u64 quiesceTableHits = statistics.quiesceTable.cuts;
+		u64 allTableHits = tableHits + quiesceTableHits;
+		log->getStream() << "Search Table Hits : " << tableHits << "(" << (double)tableHits / (double)allTableHits * 100.0 << "%)" <<
+			", Quiescent Table Hits: " << quiesceTableHits << "(" << (double)quiesceTableHits / (double)allTableHits * 100.0 << "%)" <<
+			", Table Hits: " << allTableHits << std::endl;
+		log->getStream() << "Evaluations: " << statistics.evaluations << std::endl;
+		if (statisticsFile.is_open()) {
+			int time = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginSearch).count();
+			statistics.writeJSON(statisticsFile, board->getHash(), std::min(d, depth), selDepth, time, nodes, quiesceNodes);
+		}
+	}
+	if (bestMove.movingPiece == nullptr) {
+		log->getStream() << "No legal move, score: " << (float)score / 100.0f << std::endl;
+	}
+	else {
+		log->getStream() << "Best move: " << board->getMoveStringAlgebraic(bestMove) << " , score: " << (float)score / 100.0f << std::endl;
+	}
+	log->writePV(principalVariation);
 	log->writeBoard();
 }
 
-int Searcher::pvSearchRoot(int depth) {
-	int alpha = -MAX_SCORE;
-	int beta = MAX_SCORE;
-
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::pvSearchRoot(int depth) {
 	nodes++;
 
 	Move moves[128];
-	int n = board->generateMoves(board->getColorToMove(), moves);
-	std::sort(moves, moves + n, moveComparator);
+	int n = generateMoves(moves);
 
+	// each pass finds the best move among the moves not chosen by the previous passes
+	std::vector<RootLine> lines;
 	int score;
-	int bestMoveIndex = -1;
-	for (int i = 0; i < n; i++) {
-		Move& m = moves[i];
-		board->makeMove(m);
+	for (int line = 0; line < multiPV; line++) {
+		int alpha = -MAX_SCORE;
+		int beta = MAX_SCORE;
+		pvLength[0] = 0;
+
+		int bestMoveIndex = -1;
+		int legalMoves = 0;
+		for (int i = 0; i < n; i++) {
+			Move& m = moves[i];
+			bool excluded = false;
+			for (int j = 0; j < lines.size(); j++) {
+				excluded |= lines[j].move.equals(m);
+			}
+			if (excluded) {
+				continue;
+			}
 
-		if (board->inCheck(m.color)) {
-			board->unmakeMove(m);
-			continue;
-		}
+			board->makeMove(m);
 
-		if (i == 0 || -pvSearch(-alpha - 1, -alpha, depth - 1, false) > alpha) {
-			score = -pvSearch(-beta, -alpha, depth - 1, true);
-			if (score > alpha && !timeUp) {
-				bestMoveIndex = i;
-				alpha = score;
+			if (board->inCheck(m.color)) {
+				board->unmakeMove(m);
+				continue;
 			}
-		}
-		board->unmakeMove(m);
-		if (timeUp) {
-			// if we didn't find a move in the first iteration, take a move of which we know it is legal
-			if (depth == 2) {
-				bestMove = moves[bestMoveIndex < 0 ? i : bestMoveIndex];
+
+			// long searches tell which move is being searched
+			legalMoves++;
+			if (infoCallback && std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginSearch).count() > 3000) {
+				infoCallback("info depth " + std::to_string(depth) + " currmove " + m.toString() + " currmovenumber " + std::to_string(legalMoves));
 			}
-			return score;
+
+			if (legalMoves == 1 || -pvSearch(-alpha - 1, -alpha, depth - 1, false) > alpha) {
+				score = -pvSearch(-beta, -alpha, depth - 1, true);
+				if (score > alpha && !timeUp) {
+					bestMoveIndex = i;
+					alpha = score;
+					updatePrincipalVariation(0, m);
+				}
+			}
+			board->unmakeMove(m);
+			if (timeUp) {
+				// if we didn't find a move in the first iteration, take a move of which we know it is legal
+				if (depth == 1) {
+					bestMove = lines.empty() ? moves[bestMoveIndex < 0 ? i : bestMoveIndex] : lines[0].move;
+					principalVariation.assign(1, bestMove);
+				}
+				return score;
+			}
+		}
+
+		// fewer legal moves than lines
+		if (bestMoveIndex < 0) {
+			break;
 		}
+		RootLine rootLine;
+		rootLine.move = moves[bestMoveIndex];
+		rootLine.score = alpha;
+		rootLine.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+		lines.push_back(rootLine);
 	}
-	
-	bestMove = moves[bestMoveIndex];
-	transTable->store(TranspositionEntry(board->getHash(), depth, alpha, TranspositionEntry::HASH_EXACT, bestMove));
-	return alpha;
+
+	rootLines = lines;
+	// mate or stalemate, there is no move to play
+	if (rootLines.empty()) {
+		bestMove = Move();
+		principalVariation.clear();
+		return board->inCheck(board->getColorToMove()) ? -MATE_SCORE : 0;
+	}
+	bestMove = rootLines[0].move;
+	principalVariation = rootLines[0].pv;
+	transTable->store(TranspositionEntry(board->getHash(), depth, rootLines[0].score, TranspositionEntry::HASH_EXACT, bestMove));
+	return rootLines[0].score;
 }
 
-Move Searcher::getBestMove() {
+template <class EvaluatorT, bool Statistics>
+Move Searcher<EvaluatorT, Statistics>::getBestMove() {
 	return bestMove;
 }
 
-int Searcher::pvSearch(int alpha, int beta, int depth, bool pvNode) {
+template <class EvaluatorT, bool Statistics>
+std::vector<Move> Searcher<EvaluatorT, Statistics>::getPrincipalVariation() {
+	return principalVariation;
+}
+
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::pvSearch(int alpha, int beta, int depth, bool pvNode) {
+	PROFILE_SCOPE(Search);
 	if (timeUp) {
 		return 0;
 	}
-	else if ((nodes & 4095) == 0) {
+	else if (nodeLimit > 0 || (nodes & 4095) == 0) {
 		checkTimeUp();
 	}
 
-	if (depth == 0) {
+	int ply = board->getNumberOfMoves() - rootPly;
+	pvLength[ply] = ply;
+	selDepth = std::max(selDepth, ply);
+
+	if (depth == 0 || ply == MAX_PLY - 1) {
 		return quiesce(alpha, beta);
 	}
 
-	if (!board->sufficientMaterial() || board->isRepetition()) {
+	MaterialEntry* materialEntry = board->getMaterialEntry();
+	if (!materialEntry->sufficientMaterial || board->isRepetition() || board->isFiftyMoveDraw() || Endgame::isBitbaseDraw(board, materialEntry)) {
 		return 0;
 	}
 
-	TranspositionEntry* entry = dynamic_cast<TranspositionEntry*>(transTable->find(board->getHash()));
+	// the side to move can repeat the position, so it gets at least a draw
+	if (alpha < 0 && board->hasUpcomingRepetition(board->getNumberOfMoves() - rootPly)) {
+		alpha = 0;
+		if (alpha >= beta) {
+			return alpha;
+		}
+	}
+
+	TranspositionEntry* entry = probeTable();
+	if (Statistics) {
+		countTableProbe(statistics.table, entry);
+	}
 	if (entry->hash == board->getHash() && entry->depth >= depth) {
-		if (entry->flag == TranspositionEntry::HASH_EXACT) {
-			tableHits++;
-			return entry->score;
+		int entryScore = scoreFromTable(entry->score, ply);
+		if (!pvNode && entry->flag == TranspositionEntry::HASH_EXACT) {
+			if (Statistics) {
+				countTableCut(depth);
+			}
+			return entryScore;
 		}
-		else if (!pvNode && entry->flag == TranspositionEntry::HASH_ALPHA && entry->score <= alpha) {
-			tableHits++;
+		else if (!pvNode && entry->flag == TranspositionEntry::HASH_ALPHA && entryScore <= alpha) {
+			if (Statistics) {
+				countTableCut(depth);
+			}
 			return alpha;
 		}
-		else if (!pvNode && entry->flag == TranspositionEntry::HASH_BETA && entry->score >= beta) {
-			tableHits++;
+		else if (!pvNode && entry->flag == TranspositionEntry::HASH_BETA && entryScore >= beta) {
+			if (Statistics) {
+				countTableCut(depth);
+			}
 			return beta;
 		}
 	}
 
+	// exact results of small endgames, after the transposition table which answers most repeated positions
+	int tablebaseScore;
+	if (tablebases->probe(board, tablebaseScore)) {
+		if (Statistics) {
+			statistics.tablebaseHits++;
+		}
+		return tablebaseScore;
+	}
+
 	nodes++;
+	if (Statistics) {
+		statistics.atDepth(depth).nodes++;
+	}
 
 	Move moves[128];
-	int n = board->generateMoves(board->getColorToMove(), moves);
-
-	std::sort(moves, moves + n, moveComparator);
+	int n = generateMoves(moves);
 
 	int score;
 	int bestMoveIndex = -1;
-	bool hasLegalMove = false;
+	int legalMoves = 0;
 	for (int i = 0; i < n; i++) {
 		Move& m = moves[i];
 
@@ -170,18 +291,28 @@ int Searcher::pvSearch(int alpha, int beta, int depth, bool pvNode) {
 			continue;
 		}
 
-		hasLegalMove = true;
+		legalMoves++;
 
 		if (i == 0 || -pvSearch(-alpha - 1, -alpha, depth - 1, false) > alpha) {
 			score = -pvSearch(-beta, -alpha, depth - 1, true);
 			if (score > alpha && !timeUp) {
 				if (score >= beta) {
+					if (Statistics) {
+						SearchStatistics::DepthCounters& counters = statistics.atDepth(depth);
+						counters.cutoffs++;
+						if (legalMoves == 1) {
+							counters.firstMoveCutoffs++;
+						}
+					}
 					board->unmakeMove(m);
-					transTable->store(TranspositionEntry(board->getHash(), depth, beta, TranspositionEntry::HASH_BETA, m));
+					transTable->store(TranspositionEntry(board->getHash(), depth, scoreToTable(beta, ply), TranspositionEntry::HASH_BETA, m));
 					return beta;
 				}
 				alpha = score;
 				bestMoveIndex = i;
+				if (pvNode) {
+					updatePrincipalVariation(ply, m);
+				}
 			}
 		}
 		board->unmakeMove(m);
@@ -192,9 +323,9 @@ int Searcher::pvSearch(int alpha, int beta, int depth, bool pvNode) {
 	}
 
 	// check mate and stalemate
-	if (!hasLegalMove) {
+	if (legalMoves == 0) {
 		if (board->inCheck(board->getColorToMove())) {
-			return -MATE_SCORE * depth; // prefer near mates
+			return -MATE_SCORE + ply; // prefer near mates
 		}
 		else {
 			return 0;
@@ -202,31 +333,75 @@ int Searcher::pvSearch(int alpha, int beta, int depth, bool pvNode) {
 	}
 
 	if (bestMoveIndex < 0) {
-		transTable->store(TranspositionEntry(board->getHash(), depth, alpha, TranspositionEntry::HASH_ALPHA, Move()));
+		transTable->store(TranspositionEntry(board->getHash(), depth, scoreToTable(alpha, ply), TranspositionEntry::HASH_ALPHA, Move()));
 	}
 	else {
-		transTable->store(TranspositionEntry(board->getHash(), depth, alpha, TranspositionEntry::HASH_EXACT, moves[bestMoveIndex]));
+		transTable->store(TranspositionEntry(board->getHash(), depth, scoreToTable(alpha, ply), TranspositionEntry::HASH_EXACT, moves[bestMoveIndex]));
 	}
 
 	return alpha;
 }
 
-int Searcher::quiesce(int alpha, int beta) {
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::quiesce(int alpha, int beta) {
+	PROFILE_SCOPE(Quiesce);
 	if (timeUp) {
 		return 0;
 	}
-	else if ((quiesceNodes & 8191) == 0) {
+	else if (nodeLimit > 0 || (quiesceNodes & 8191) == 0) {
 		checkTimeUp();
 	}
 
-	evaluations++;
-	int standPattern = evaluator->evaluate();
+	int ply = board->getNumberOfMoves() - rootPly;
+	selDepth = std::max(selDepth, ply);
+
+	// quiescence entries are stored with depth 0, entries of the main search are at least as good
+	TranspositionEntry* entry = probeTable();
+	if (Statistics) {
+		countTableProbe(statistics.quiesceTable, entry);
+	}
+	if (entry->hash == board->getHash()) {
+		int entryScore = scoreFromTable(entry->score, ply);
+		if (entry->flag == TranspositionEntry::HASH_EXACT) {
+			if (Statistics) {
+				statistics.quiesceTable.cuts++;
+			}
+			return entryScore;
+		}
+		else if (entry->flag == TranspositionEntry::HASH_ALPHA && entryScore <= alpha) {
+			if (Statistics) {
+				statistics.quiesceTable.cuts++;
+			}
+			return alpha;
+		}
+		else if (entry->flag == TranspositionEntry::HASH_BETA && entryScore >= beta) {
+			if (Statistics) {
+				statistics.quiesceTable.cuts++;
+			}
+			return beta;
+		}
+	}
+
+	if (Statistics) {
+		statistics.evaluations++;
+	}
+	int standPattern;
+	{
+		PROFILE_SCOPE(Evaluation);
+		standPattern = evaluator->evaluate(alpha, beta);
+	}
 	if (standPattern >= beta) {
+		if (Statistics) {
+			statistics.standPatCuts++;
+		}
 		return beta;
 	}
 
 	// check if capturing a queen could raise alpha 
 	if (standPattern + DefaultEvaluator::PIECE_WORTH[Piece::Queen] < alpha) {
+		if (Statistics) {
+			statistics.futilityPrunes++;
+		}
 		return alpha;
 	}
 
@@ -237,10 +412,18 @@ int Searcher::quiesce(int alpha, int beta) {
 	quiesceNodes++;
 
 	Move captures[128];
-	int n = board->generateCaptures(board->getColorToMove(), captures);
-	std::sort(captures, captures + n, moveComparator);
+	int n;
+	{
+		PROFILE_SCOPE(MoveGeneration);
+		n = board->generateCaptures(board->getColorToMove(), captures);
+	}
+	{
+		PROFILE_SCOPE(MoveOrdering);
+		std::sort(captures, captures + n, moveComparator);
+	}
 
 	int score;
+	int bestMoveIndex = -1;
 	for (int i = 0; i < n; i++) {
 		Move& m = captures[i];
 		if (m.capturedPiece->type == Piece::King) {
@@ -248,6 +431,9 @@ int Searcher::quiesce(int alpha, int beta) {
 		}
 		// delta pruning
 		if (standPattern + DefaultEvaluator::PIECE_WORTH[m.capturedPiece->type] + 200 < alpha) {
+			if (Statistics) {
+				statistics.deltaPrunes++;
+			}
 			continue;
 		}
 
@@ -264,29 +450,149 @@ int Searcher::quiesce(int alpha, int beta) {
 		}
 		
 		if (score > alpha) {
-			alpha = score; 
 			if (score >= beta) {
+				if (Statistics) {
+					statistics.quiesceCutoffs++;
+				}
+				storeQuiesceEntry(beta, TranspositionEntry::HASH_BETA, m);
 				return beta;
 			}
+			alpha = score;
+			bestMoveIndex = i;
 		}
 	}
+
+	if (bestMoveIndex < 0) {
+		storeQuiesceEntry(alpha, TranspositionEntry::HASH_ALPHA, Move());
+	}
+	else {
+		storeQuiesceEntry(alpha, TranspositionEntry::HASH_EXACT, captures[bestMoveIndex]);
+	}
 	return alpha;
 }
 
-void Searcher::checkTimeUp() {
-	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-	timeUp = std::chrono::duration_cast<std::chrono::milliseconds>(now - beginSearch).count() > timeLimit;
+// the generated moves sorted by the move comparator
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::generateMoves(Move* moves) {
+	int n;
+	{
+		PROFILE_SCOPE(MoveGeneration);
+		n = board->generateMoves(board->getColorToMove(), moves);
+	}
+	PROFILE_SCOPE(MoveOrdering);
+	std::sort(moves, moves + n, moveComparator);
+	return n;
 }
 
-void Searcher::setEvaluator(Evaluator* evaluator) {
-	this->evaluator = evaluator;
+template <class EvaluatorT, bool Statistics>
+TranspositionEntry* Searcher<EvaluatorT, Statistics>::probeTable() {
+	PROFILE_SCOPE(TableProbe);
+	TranspositionEntry* entry = transTable->find(board->getHash());
+	if (GAUDI_PROFILE) {
+		// touch the entry, so the cache miss is counted here
+		volatile u64 hash = entry->hash;
+		(void)hash;
+	}
+	return entry;
 }
 
-void Searcher::test(std::string fen, int depth) {
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::storeQuiesceEntry(int score, u8 flag, Move bestMove) {
+	// never replace results of the main search by quiescence results
+	TranspositionEntry* entry = transTable->find(board->getHash());
+	if (entry->depth > 0) {
+		return;
+	}
+	transTable->store(TranspositionEntry(board->getHash(), 0, scoreToTable(score, board->getNumberOfMoves() - rootPly), flag, bestMove));
+}
+
+// mate scores are stored relative to the node, so they stay valid at other plies
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::scoreToTable(int score, int ply) {
+	if (score >= MATE_SCORE - MAX_PLY) {
+		return score + ply;
+	}
+	else if (score <= -MATE_SCORE + MAX_PLY) {
+		return score - ply;
+	}
+	return score;
+}
+
+template <class EvaluatorT, bool Statistics>
+int Searcher<EvaluatorT, Statistics>::scoreFromTable(int score, int ply) {
+	if (score >= MATE_SCORE - MAX_PLY) {
+		return score - ply;
+	}
+	else if (score <= -MATE_SCORE + MAX_PLY) {
+		return score + ply;
+	}
+	return score;
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::sendInfo(int depth) {
+	if (!infoCallback) {
+		return;
+	}
+
+	int time = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - beginSearch).count();
+	u64 allNodes = (u64)nodes + quiesceNodes;
+	for (int i = 0; i < rootLines.size(); i++) {
+		std::string info = "info depth " + std::to_string(depth) + " seldepth " + std::to_string(selDepth);
+		if (multiPV > 1) {
+			info += " multipv " + std::to_string(i + 1);
+		}
+		int score = rootLines[i].score;
+		if (isMateScore(score)) {
+			// plies to the mate converted to moves, negative if the engine gets mated
+			int plies = MATE_SCORE - std::abs(score);
+			info += " score mate " + std::to_string(score > 0 ? (plies + 1) / 2 : -plies / 2);
+		}
+		else {
+			info += " score cp " + std::to_string(score);
+		}
+		info += " nodes " + std::to_string(allNodes) + " nps " + std::to_string(allNodes * 1000 / std::max(time, 1)) +
+			" hashfull " + std::to_string(transTable->getUsage()) + " time " + std::to_string(time) + " pv";
+		for (int j = 0; j < rootLines[i].pv.size(); j++) {
+			info += " " + rootLines[i].pv[j].toString();
+		}
+		infoCallback(info);
+	}
+}
+
+// the move followed by the line of the child node
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::updatePrincipalVariation(int ply, Move& move) {
+	pvTable[ply][ply] = move;
+	for (int i = ply + 1; i < pvLength[ply + 1]; i++) {
+		pvTable[ply][i] = pvTable[ply + 1][i];
+	}
+	pvLength[ply] = pvLength[ply + 1];
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::checkTimeUp() {
+	if (isStopped()) {
+		timeUp = true;
+		return;
+	}
+	if (nodeLimit > 0) {
+		timeUp = (u64)nodes + quiesceNodes >= nodeLimit;
+		return;
+	}
+	if (isPondering()) {
+		return;
+	}
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	timeUp = std::chrono::duration_cast<std::chrono::milliseconds>(now - beginSearch).count() > timeLimit;
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::test(std::string fen, int depth) {
 	board->loadFEN(fen);
 
 	search(depth, 5000);
-	log->writePV();
+	log->writePV(principalVariation);
 
 	Move moves[128];
 	int n = board->generateMoves(board->getColorToMove(), moves);
@@ -301,10 +607,46 @@ void Searcher::test(std::string fen, int depth) {
 	log->getStream() << std::endl;
 }
 
-void Searcher::assertBoardHash(u64 should) {
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::setStatisticsFile(std::string filename) {
+	if (!Statistics) {
+		return;
+	}
+	if (statisticsFile.is_open()) {
+		statisticsFile.close();
+	}
+	statisticsFile.open(filename, std::ios::app);
+	if (!statisticsFile.is_open()) {
+		std::cerr << "Statistics file '" << filename << "' could not be opened!" << std::endl;
+	}
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::countTableProbe(SearchStatistics::TableCounters& counters, TranspositionEntry* entry) {
+	counters.probes++;
+	if (entry->hash == board->getHash()) {
+		counters.hits++;
+	}
+	else if (entry->hash != 0) {
+		counters.collisions++;
+	}
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::countTableCut(int depth) {
+	statistics.table.cuts++;
+	statistics.atDepth(depth).tableCuts++;
+}
+
+template <class EvaluatorT, bool Statistics>
+void Searcher<EvaluatorT, Statistics>::assertBoardHash(u64 should) {
 	if (should != board->getHash())
 	{
 		std::cout << "PRE/AFTER HASHES DO NOT MATCH: " << should << " vs " << board->getHash() << std::endl;
 		board->print(std::cout);
 	}
-}
\ No newline at end of file
+}
+
+template class Searcher<DefaultEvaluator>;
+template class Searcher<LuaEvaluator>;
+template class Searcher<NNUEEvaluator>;
\ No newline at end of file
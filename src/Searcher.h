@@ -1,5 +1,11 @@
 #pragma once
 #include <chrono>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <atomic>
 
 #include "Board.h"
 #include "evaluation/Evaluator.h"
@@ -8,41 +14,155 @@
 #include "hashing/TranspositionEntry.h"
 #include "ZobristHasher.h"
 #include "Log.h"
+#include "SearchStatistics.h"
+#include "tablebase/Tablebases.h"
 
-class Searcher
+// collect the counters of SearchStatistics, off in release builds
+#ifndef GAUDI_SEARCH_STATISTICS
+#ifdef _DEBUG
+#define GAUDI_SEARCH_STATISTICS true
+#else
+#define GAUDI_SEARCH_STATISTICS false
+#endif
+#endif
+
+// Interface of the search, the engine does not need to know the evaluator type.
+class SearcherBase
 {
 public:
 	static const int MAX_SCORE = 1000000000;
 	static const int MATE_SCORE = 1000000;
+	static const int MAX_PLY = 128;
+	static const int MAX_MULTI_PV = 64;
+
+	virtual ~SearcherBase() = default;
+	virtual void search(int depth, int timeLimitMs) = 0;
+	virtual Move getBestMove() = 0;
+	// best line of the last completed iteration, starting with the best move
+	virtual std::vector<Move> getPrincipalVariation() = 0;
+	virtual void test(std::string fen, int depth) = 0;
+	// appends the statistics of each search as a json line, only with statistics enabled
+	virtual void setStatisticsFile(std::string filename) = 0;
+
+	// receives the uci info lines during the search
+	void setInfoCallback(std::function<void(const std::string&)> callback) {
+		infoCallback = callback;
+	}
+
+	// number of best root moves searched with exact scores
+	void setMultiPV(int lines) {
+		// std::min takes references, the constant is copied because it has no definition
+		multiPV = std::max(1, std::min(lines, (int)MAX_MULTI_PV));
+	}
+
+	// stop after the given number of nodes instead of watching the clock, 0 for no limit
+	// a node limited search does not read the time, so it searches the same tree on every machine
+	void setNodeLimit(u64 nodes) {
+		nodeLimit = nodes;
+	}
+
+	// searches are numbered by prepareSearch, a pondering search ignores the clock until ponderHit
+	void prepareSearch(int search, bool ponder) {
+		searchNumber = search;
+		pondering = ponder;
+	}
+
+	// these may be called from another thread, also while searching
+	// they apply to all searches up to the given number, so they are not undone by preparing the next search
+
+	void stop(int upToSearch) {
+		stoppedUpTo = upToSearch;
+	}
+
+	void ponderHit(int upToSearch) {
+		ponderHitUpTo = upToSearch;
+	}
+
+	// mate scores are MATE_SCORE minus the distance to the mate in plies
+	static bool isMateScore(int score) {
+		return score >= MATE_SCORE - MAX_PLY || score <= -MATE_SCORE + MAX_PLY;
+	}
+protected:
+	std::function<void(const std::string&)> infoCallback;
+	int multiPV = 1;
+	u64 nodeLimit = 0;
+	int searchNumber = 0;
+	bool pondering = false;
+	std::atomic<int> stoppedUpTo{ -1 };
+	std::atomic<int> ponderHitUpTo{ -1 };
 
-	Searcher(Board* board, Evaluator* evaluator, HashTable<TranspositionEntry>* transTable, Log* log);
+	bool isStopped() {
+		return stoppedUpTo >= searchNumber;
+	}
+
+	bool isPondering() {
+		return pondering && ponderHitUpTo < searchNumber;
+	}
+};
+
+// The search specialized for an evaluator, so evaluation calls are resolved at compile time.
+// Instantiated in Searcher.cpp for all evaluators.
+template <class EvaluatorT, bool Statistics = GAUDI_SEARCH_STATISTICS>
+class Searcher : public SearcherBase
+{
+public:
+	Searcher(Board* board, EvaluatorT* evaluator, HashTable<TranspositionEntry>* transTable, Tablebases* tablebases, Log* log);
 	void search(int depth, int timeLimitMs);
 	int pvSearchRoot(int depth);
 	Move getBestMove();
+	std::vector<Move> getPrincipalVariation();
 	int pvSearch(int alpha, int beta, int depth, bool pvNode); 
 	int quiesce(int alpha, int beta);
 
+	// sets timeUp once the time or the node limit is exhausted
 	void checkTimeUp();
-	void setEvaluator(Evaluator* evaluator);
 
 	void test(std::string fen, int depth);
+	void setStatisticsFile(std::string filename);
 	void assertBoardHash(u64 should);
 private:
+	int generateMoves(Move* moves);
+	TranspositionEntry* probeTable();
+	void storeQuiesceEntry(int score, u8 flag, Move bestMove);
+	void updatePrincipalVariation(int ply, Move& move);
+	void sendInfo(int depth);
+	void countTableProbe(SearchStatistics::TableCounters& counters, TranspositionEntry* entry);
+	void countTableCut(int depth);
+	static int scoreToTable(int score, int ply);
+	static int scoreFromTable(int score, int ply);
+
 	Board* board;
-	Evaluator* evaluator;
+	EvaluatorT* evaluator;
 	HashTable<TranspositionEntry>* transTable;
+	Tablebases* tablebases;
 	Log* log;
 	MoveComparator moveComparator;
 	Move bestMove;
 
+	// triangular table of the principal variations, the line found at a ply starts at pvTable[ply][ply]
+	Move pvTable[MAX_PLY][MAX_PLY];
+	int pvLength[MAX_PLY];
+	std::vector<Move> principalVariation;
+
+	// a root move with its exact score, ranked by the pass that found it
+	struct RootLine
+	{
+		Move move;
+		int score;
+		std::vector<Move> pv;
+	};
+	std::vector<RootLine> rootLines;
+
 	int nodes;
 	int quiesceNodes;
-	int tableHits;
-	int quiesceTableHits;
-	int evaluations;
+	SearchStatistics statistics;
+	std::ofstream statisticsFile;
+	// deepest ply reached, including the quiescence search
+	int selDepth;
 
 	std::chrono::steady_clock::time_point beginSearch;
 	int timeLimit;
+	// number of moves played before the search started
+	int rootPly;
 	bool timeUp;
 };
-
@@ -2,82 +2,163 @@
 #include "Helpers.h"
 
 #include <iostream>
+#include <climits>
 #include <algorithm>
 
 UCIProtocolHandler::UCIProtocolHandler(Engine* engine) {
 	this->engine = engine;
+	goCount = 0;
+	releasedUpTo = 0;
+	searching = false;
 }
 
 void UCIProtocolHandler::run() {
+	// only the protocol reports the search, the tests and the self play stay silent
+	engine->setInfoCallback([this](const std::string& info) { send(info); });
+	std::thread reader(&UCIProtocolHandler::readInput, this);
 	bool quit = false;
-	bool think = false;
-	std::string line;
+	int search = 0;
 	while (!quit) {
-		if (think) {
-			send("bestmove " + engine->move().toString());
-			think = false;
-		}
-
-		std::getline(std::cin, line);
-		engine->getLog()->writeMessage("Server: " + line);
-
+		std::string line = popCommand();
 		std::vector<std::string> parts = Helpers::splitString(line);
+		if (parts[0].empty()) {
+			continue;
+		}
 
 		if (parts[0] == "uci") {
 			send("id name " + engine->engineName);
 			send("id author kroemker");
+			send("option name MultiPV type spin default 1 min 1 max " + std::to_string(SearcherBase::MAX_MULTI_PV));
 			send("uciok");
 		}
 		else if (parts[0] == "ucinewgame") {
 			engine->startNewGame();
 		}
-		else if (parts[0] == "isready") {
-			send("readyok");
+		else if (parts[0] == "setoption") {
+			// setoption name <name> value <value>, names may contain spaces
+			std::string name, value;
+			int i = 1;
+			if (i < parts.size() && parts[i] == "name") {
+				for (i++; i < parts.size() && parts[i] != "value"; i++) {
+					name += (name.empty() ? "" : " ") + parts[i];
+				}
+			}
+			if (i < parts.size() && parts[i] == "value") {
+				for (i++; i < parts.size(); i++) {
+					value += (value.empty() ? "" : " ") + parts[i];
+				}
+			}
+			// option names are case insensitive, invalid values are ignored
+			int number;
+			if (Helpers::equalsIgnoreCase(name, "MultiPV") && Helpers::parseInt(value, number)) {
+				engine->setMultiPV(number);
+			}
 		}
-		else if (parts[0] == "position") {
+		else if (parts[0] == "position" && parts.size() > 1) {
+			// position [fen <fen> | startpos] [moves <move> ...]
+			std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 			int index = 2;
-			std::string fenOrStartpos = parts[1];
-			if (fenOrStartpos == "fen") {
-				std::string pos = parts[2], color = parts[3], cr = parts[4], enp = parts[5], ply = parts[6], nmov = parts[7];
-				engine->setBoard(pos + " " + color + " " + cr + " " + enp + " " + ply + " " + nmov);
-				index = 8;
-			}
-			else if (fenOrStartpos == "startpos") {
-				engine->setBoard("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+			if (parts[1] == "fen") {
+				fen.clear();
+				for (; index < parts.size() && parts[index] != "moves"; index++) {
+					fen += (fen.empty() ? "" : " ") + parts[index];
+				}
 			}
 
+			std::vector<std::string> moves;
 			if (index < parts.size() && parts[index] == "moves") {
-				for (index = index + 1; index < parts.size(); index++) {
-					engine->doMove(parts[index]);
-				}
+				moves.assign(parts.begin() + index + 1, parts.end());
 			}
+			engine->setPosition(fen, moves);
 		}
 		else if (parts[0] == "go") {
-			think = true;
+			// the limits only hold for this search, the clock keeps its settings
+			bool timed = false;
+			bool limited = false;
+			bool infinite = false;
+			bool ponder = false;
+			int moveTime = 0;
+			engine->setSearchDepth(Engine::DEFAULT_SEARCH_DEPTH);
+			engine->setNodeLimit(0);
 			for (int i = 0; i < parts.size(); i++) {
+				// a missing or invalid value ignores the limit
+				int value;
+				bool valid = i + 1 < parts.size() && Helpers::parseInt(parts[i + 1], value);
 				if (parts[i] == "depth") {
-					engine->setSearchDepth(std::stoi(parts[++i]));
+					if (valid && value > 0) {
+						engine->setSearchDepth(std::min(value, SearcherBase::MAX_PLY - 1));
+						limited = true;
+					}
+				}
+				else if (parts[i] == "nodes") {
+					if (valid && value > 0) {
+						engine->setNodeLimit(value);
+						limited = true;
+					}
 				}
 				else if (parts[i] == "wtime") {
-					engine->setClockTime(Color::WHITE, std::stoi(parts[++i]));
+					if (valid) {
+						engine->setClockTime(Color::WHITE, value);
+						timed = true;
+					}
 				}
 				else if (parts[i] == "btime") {
-					engine->setClockTime(Color::BLACK, std::stoi(parts[++i]));
+					if (valid) {
+						engine->setClockTime(Color::BLACK, value);
+						timed = true;
+					}
 				}
 				else if (parts[i] == "winc") {
-					engine->setClockIncrement(Color::WHITE, std::stoi(parts[++i]));
+					if (valid) {
+						engine->setClockIncrement(Color::WHITE, value);
+					}
 				}
 				else if (parts[i] == "binc") {
-					engine->setClockIncrement(Color::BLACK, std::stoi(parts[++i]));
+					if (valid) {
+						engine->setClockIncrement(Color::BLACK, value);
+					}
 				}
 				else if (parts[i] == "movetime") {
-					engine->setMoveTime(std::stoi(parts[++i]));
+					if (valid && value > 0) {
+						moveTime = value;
+						timed = true;
+					}
+				}
+				else if (parts[i] == "infinite") {
+					infinite = true;
+				}
+				else if (parts[i] == "ponder") {
+					ponder = true;
+				}
+			}
+			if (infinite) {
+				engine->setSearchDepth(SearcherBase::MAX_PLY - 1);
+				moveTime = INT_MAX;
+			}
+			// go depth and go nodes without a clock are not cut short by the time
+			else if (limited && !timed) {
+				moveTime = INT_MAX;
+			}
+
+			// numbered like the reader numbers the gos, a stop read before this point already applies
+			search++;
+			engine->prepareSearch(search, ponder);
+			{
+				std::lock_guard<std::mutex> lock(commandMutex);
+				searching = true;
+			}
+			Move move = engine->move(moveTime);
+			{
+				std::unique_lock<std::mutex> lock(commandMutex);
+				if (ponder || infinite) {
+					commandAvailable.wait(lock, [this, search] { return releasedUpTo >= search; });
 				}
+				searching = false;
 			}
+			sendBestMove(move);
 		}
-		else if (parts[0] == "stop") {
-			think = false;
-			send("bestmove " + engine->move().toString());
+		else if (parts[0] == "isready") {
+			send("readyok");
 		}
 		else if (parts[0] == "quit") {
 			quit = true;
@@ -87,9 +168,93 @@ void UCIProtocolHandler::run() {
 			engine->showBoardDebug();
 		}
 	}
+	reader.join();
 }
 
 void UCIProtocolHandler::send(std::string s) {
-	std::cout << s << std::endl;
-	engine->getLog()->writeMessage("Engine: " + s);
+	{
+		std::lock_guard<std::mutex> lock(outputMutex);
+		std::cout << s << '\n';
+		std::cout.flush();
+	}
+	engine->getLog()->writeMessage("Engine: " + s, Log::Debug);
+}
+
+// answers the commands which can't wait for the search, queues the others
+void UCIProtocolHandler::readInput() {
+	std::string line;
+	while (std::getline(std::cin, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		engine->getLog()->writeMessage("Server: " + line, Log::Debug);
+
+		std::vector<std::string> parts = Helpers::splitString(line);
+		bool searchRunning;
+		{
+			std::lock_guard<std::mutex> lock(commandMutex);
+			searchRunning = searching;
+		}
+		// otherwise readyok is sent once the queued commands are done, a go which is only queued does not count
+		if (parts[0] == "isready" && searchRunning) {
+			send("readyok");
+		}
+		else if (parts[0] == "stop") {
+			engine->stopSearch(releaseBestMoves());
+		}
+		else if (parts[0] == "ponderhit") {
+			engine->ponderHit(releaseBestMoves());
+		}
+		else if (parts[0] == "quit") {
+			engine->stopSearch(releaseBestMoves());
+			pushCommand(line);
+			return;
+		}
+		else {
+			if (parts[0] == "go") {
+				std::lock_guard<std::mutex> lock(commandMutex);
+				goCount++;
+			}
+			pushCommand(line);
+		}
+	}
+	// end of input, like quit
+	engine->stopSearch(releaseBestMoves());
+	pushCommand("quit");
+}
+
+int UCIProtocolHandler::releaseBestMoves() {
+	int upTo;
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		releasedUpTo = goCount;
+		upTo = goCount;
+	}
+	commandAvailable.notify_all();
+	return upTo;
+}
+
+void UCIProtocolHandler::pushCommand(std::string line) {
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		commands.push_back(line);
+	}
+	commandAvailable.notify_all();
+}
+
+std::string UCIProtocolHandler::popCommand() {
+	std::unique_lock<std::mutex> lock(commandMutex);
+	commandAvailable.wait(lock, [this] { return !commands.empty(); });
+	std::string line = commands.front();
+	commands.pop_front();
+	return line;
+}
+
+void UCIProtocolHandler::sendBestMove(Move move) {
+	std::string answer = "bestmove " + move.toString();
+	Move ponderMove;
+	if (engine->getPonderMove(ponderMove)) {
+		answer += " ponder " + ponderMove.toString();
+	}
+	send(answer);
 }
\ No newline at end of file
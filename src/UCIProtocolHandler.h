@@ -2,15 +2,41 @@
 
 #include <vector>
 #include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Engine.h"
 
+// Commands are read on their own thread, so isready, stop and ponderhit are answered while the engine searches.
+// Without a search isready is queued, readyok then confirms that the commands before it are done.
+// All other commands are queued and run in order on the thread calling run.
 class UCIProtocolHandler
 {
 public:
 	UCIProtocolHandler(Engine* engine);
 	void run();
+	// thread safe, one flush per message
 	void send(std::string s);
 private:
+	void readInput();
+	void pushCommand(std::string line);
+	std::string popCommand();
+	void sendBestMove(Move move);
+	// releases the held best moves of all gos read so far, returns their number
+	int releaseBestMoves();
+
 	Engine* engine;
+
+	std::deque<std::string> commands;
+	std::mutex commandMutex;
+	std::condition_variable commandAvailable;
+	// the gos are numbered in the order they are read, a stop or ponderhit applies to all gos before it
+	int goCount;
+	// the best move of go ponder and go infinite is sent after a stop or ponderhit
+	int releasedUpTo;
+	// set by run from the start of a search until its best move is released
+	bool searching;
+	std::mutex outputMutex;
 };
 
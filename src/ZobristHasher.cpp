@@ -2,22 +2,54 @@
 #include "Color.h"
 #include "Board.h"
 #include "Piece.h"
+#include "DeltaTables.h"
+
+#include <algorithm>
+
+// the position keys followed by the material keys of both colors
+struct ZobristKeys
+{
+	u64 values[ZobristHasher::tableSize + 2 * 6];
+};
+
+// splitmix64 with a fixed seed, so all boards and builds share the same keys
+static constexpr ZobristKeys generateZobristKeys() {
+	ZobristKeys keys = {};
+	u64 state = 0x1A2B3C4D5E6F7081ULL;
+	for (int i = 0; i < ZobristHasher::tableSize + 2 * 6; i++) {
+		state += 0x9E3779B97F4A7C15ULL;
+		u64 z = state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		keys.values[i] = z ^ (z >> 31);
+	}
+	return keys;
+}
 
-#include <cstdlib>
-#include <ctime>
+static constexpr ZobristKeys sZobristKeys = generateZobristKeys();
+static constexpr const u64* table = sZobristKeys.values;
 
-ZobristHasher::ZobristHasher(Board* board) {
-	this->board = board;
+static const int CUCKOO_SIZE = 8192;
 
-	//srand(time(NULL));
+// a move key is either at its first or its second index
+static u64 sCuckooKeys[CUCKOO_SIZE];
+static u8 sCuckooMoves[CUCKOO_SIZE][2];
 
-	for (int i = 0; i < tableSize; i++) {
-		table[i] = (u64)rand() << 32 | (u64)rand();
-	}
+static int cuckooIndex1(u64 key) {
+	return key & (CUCKOO_SIZE - 1);
+}
+
+static int cuckooIndex2(u64 key) {
+	return (key >> 16) & (CUCKOO_SIZE - 1);
+}
+
+ZobristHasher::ZobristHasher(Board* board) {
+	this->board = board;
 }
 
 void ZobristHasher::hashNew() {
 	hash = 0;
+	pawnHash = 0;
 	for (int i = 0; i < 8; i++) {
 		for (int j = 0; j < 8; j++) {
 			Piece* piece = board->getPiece(i + 16 * j);
@@ -26,6 +58,9 @@ void ZobristHasher::hashNew() {
 				int square = j * 8 + i;
 				int type = piece->type;
 				hash ^= table[offset + square + type * 64];
+				if (piece->type == Piece::Pawn) {
+					pawnHash ^= table[offset + square + type * 64];
+				}
 			}
 		}
 	}
@@ -34,7 +69,7 @@ void ZobristHasher::hashNew() {
 	hash ^= table[2 * 64 * 6 + castlingRightIndex];
 
 	if (board->getEnpassantSquare() < 128) {
-		hash ^= table[2 * 64 * 6 + 16 + board->getEnpassantSquare() & 7];
+		hash ^= table[2 * 64 * 6 + 16 + (board->getEnpassantSquare() & 7)];
 	}
 
 	if (board->getColorToMove() == Color::BLACK)
@@ -53,10 +88,15 @@ void ZobristHasher::updateHash(Move& m) {
 			int type = m.movingPiece->type;
 			hash ^= table[offset + ssquare + type * 64]; // remove piece from src
 			hash ^= table[offset + dsquare + type * 64]; // place piece on dest
+			if (type == Piece::Pawn) {
+				pawnHash ^= table[offset + ssquare + type * 64];
+				pawnHash ^= table[offset + dsquare + type * 64];
+			}
 		}
 		else {
 			hash ^= table[offset + ssquare + Piece::Pawn * 64]; // remove pawn piece from src
 			hash ^= table[offset + dsquare + m.promotionType * 64]; // place promo piece on dest
+			pawnHash ^= table[offset + ssquare + Piece::Pawn * 64];
 		}
 
 		if (m.capturedPiece != nullptr)
@@ -65,6 +105,9 @@ void ZobristHasher::updateHash(Move& m) {
 			int type = m.capturedPiece->type;
 			dsquare = Board::convert88To64Square(m.capturedPiece->square); // need this in case of enpassant capture
 			hash ^= table[offset + dsquare + type * 64]; // remove captured piece from dst
+			if (type == Piece::Pawn) {
+				pawnHash ^= table[offset + dsquare + type * 64];
+			}
 		}
 	}
 	else
@@ -87,10 +130,10 @@ void ZobristHasher::updateHash(Move& m) {
 
 	// enpassant square
 	if (m.enpassantSquare < 128) {
-		hash ^= table[2 * 64 * 6 + 16 + m.enpassantSquare & 7];
+		hash ^= table[2 * 64 * 6 + 16 + (m.enpassantSquare & 7)];
 	}
 	if (m.oldEnpassantSquare < 128) {
-		hash ^= table[2 * 64 * 6 + 16 + m.oldEnpassantSquare & 7];
+		hash ^= table[2 * 64 * 6 + 16 + (m.oldEnpassantSquare & 7)];
 	}
 
 	// switch side to move
@@ -99,4 +142,57 @@ void ZobristHasher::updateHash(Move& m) {
 
 u64 ZobristHasher::getHash() {
 	return hash;
+}
+
+u64 ZobristHasher::getPawnHash() {
+	return pawnHash;
+}
+
+u64 ZobristHasher::getMaterialKey(int color, Piece::PieceType type) {
+	return table[tableSize + color * 6 + type];
+}
+
+void ZobristHasher::initCuckooTables() {
+	std::fill(sCuckooKeys, sCuckooKeys + CUCKOO_SIZE, 0);
+	const Piece::PieceType types[] = { Piece::King, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen };
+	for (int color = 0; color < 2; color++) {
+		for (Piece::PieceType type : types) {
+			for (int s1 = 0; s1 < 64; s1++) {
+				for (int s2 = s1 + 1; s2 < 64; s2++) {
+					int from = Board::convert64To88Square(s1);
+					int to = Board::convert64To88Square(s2);
+					if (!DeltaTables::canAttack(color, type, from, to)) {
+						continue;
+					}
+
+					// insert and push the displaced entry to its other index until a slot is free
+					u64 key = table[color * 64 * 6 + type * 64 + s1] ^ table[color * 64 * 6 + type * 64 + s2] ^ table[tableSize - 1];
+					u8 move[2] = { (u8)from, (u8)to };
+					int i = cuckooIndex1(key);
+					while (true) {
+						std::swap(sCuckooKeys[i], key);
+						std::swap(sCuckooMoves[i][0], move[0]);
+						std::swap(sCuckooMoves[i][1], move[1]);
+						if (key == 0) {
+							break;
+						}
+						i = i == cuckooIndex1(key) ? cuckooIndex2(key) : cuckooIndex1(key);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool ZobristHasher::findReversibleMove(u64 moveKey, int& square1, int& square2) {
+	int i = cuckooIndex1(moveKey);
+	if (sCuckooKeys[i] != moveKey) {
+		i = cuckooIndex2(moveKey);
+		if (sCuckooKeys[i] != moveKey) {
+			return false;
+		}
+	}
+	square1 = sCuckooMoves[i][0];
+	square2 = sCuckooMoves[i][1];
+	return true;
 }
\ No newline at end of file
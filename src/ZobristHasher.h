@@ -15,10 +15,19 @@ public:
 	void hashNew();
 	void updateHash(Move& m);
 	u64 getHash();
+	u64 getPawnHash();
+
+	// key of one piece of the given type, the material key of a position is the sum over all pieces
+	static u64 getMaterialKey(int color, Piece::PieceType type);
+
+	// cuckoo tables of the hash differences of all reversible moves except pawn moves, so cycles show up in the hash history
+	static void initCuckooTables();
+	// the squares (0x88) of a reversible move changing the hash by the key, in either direction
+	static bool findReversibleMove(u64 moveKey, int& square1, int& square2);
 private:
 	Board* board; 
 	u64 hash;
-	u64 table[tableSize];
+	u64 pawnHash;
 	int castlingRightIndex;
 };
 
@@ -1,47 +1,39 @@
 #include "DefaultEvaluator.h"
 #include "../Piece.h"
+#include "PieceSquareTables.h"
+#include "../Bitboard.h"
+
+#include <limits>
 
 const int DefaultEvaluator::PIECE_WORTH[] = { 0, 100, 300, 315, 500, 1000 };
 
 static const int sKingSafetyContribution[] = { 0, 4, 1, 2, 3, 1 };
 
-static const int sWhitePawnPositionalValueTable[] =
-{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0,
-  3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0,
-  4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0,
-  5, 5, 5, 5, 5, 5, 5, 5, 0, 0, 0, 0, 0, 0, 0, 0,
-  6, 6, 6, 6, 6, 6, 6, 6, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
-static const int sBlackPawnPositionalValueTable[] =
-{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  6, 6, 6, 6, 6, 6, 6, 6, 0, 0, 0, 0, 0, 0, 0, 0,
-  5, 5, 5, 5, 5, 5, 5, 5, 0, 0, 0, 0, 0, 0, 0, 0,
-  4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0,
-  3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0,
-  2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-static const int sKnightPositionalValueTable[] =
-{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 3, 4, 4, 4, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 3, 4, 5, 5, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 3, 4, 5, 5, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 3, 4, 4, 4, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
-
-static const int* sPawnTable[] = { sWhitePawnPositionalValueTable, sBlackPawnPositionalValueTable };
+static const Score sMobilityBonus(1, 1);
+static const Score sThreatBonus(3, 3);
+static const Score sKingZoneAttackBonus(1, 0);
+static const Score sOpenKingLinePenalty(1, 0);
+
+static const Score sDoubledPawnPenalty(8, 14);
+static const Score sIsolatedPawnPenalty(8, 12);
+static const Score sConnectedPawnBonus(4, 4);
+// indexed by the rank as seen from the pawn's side
+static const Score sPassedPawnBonus[] = { Score(0, 0), Score(3, 8), Score(6, 14), Score(12, 28), Score(20, 48), Score(35, 80), Score(60, 130), Score(0, 0) };
+
+// tuned estimate of the terms skipped by the lazy evaluation, they can exceed it so the lazy score is no bound
+static const int sLazyMargin = 150;
 
 static const int queenVectorMoves[] = { -1, 1, 16, -16, -15, -17, 15, 17 };
 
-DefaultEvaluator::DefaultEvaluator(Board* board, u64 tableSize) : evalTable(tableSize) {
+DefaultEvaluator::DefaultEvaluator(Board* board, u64 tableSize, u64 pawnTableSize) : evalTable(tableSize), pawnTable(pawnTableSize) {
 	this->board = board;
 }
 
 int DefaultEvaluator::evaluate() {
+	return evaluate(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+}
+
+int DefaultEvaluator::evaluate(int alpha, int beta) {
 	EvaluationEntry* evalEntry = evalTable.find(board->getHash());
 	if (evalEntry->hash == board->getHash()) {
 		return evalEntry->score;
@@ -50,87 +42,84 @@ int DefaultEvaluator::evaluate() {
 	int color = board->getColorToMove();
 	int oppColor = Color::invert(board->getColorToMove());
 	int s = 0;
-	int materialOnBoard = 0;
 
-	// material
-	for (int i = 0; i < 6; i++) {
-		s += PIECE_WORTH[i] * (board->getPieceCount(color, (Piece::PieceType)i) - board->getPieceCount(oppColor, (Piece::PieceType)i));
-		materialOnBoard += PIECE_WORTH[i] * board->getPieceCount(color, (Piece::PieceType)i) + PIECE_WORTH[i] * board->getPieceCount(oppColor, (Piece::PieceType)i);
+	// endgames with special knowledge
+	MaterialEntry* materialEntry = board->getMaterialEntry();
+	if (materialEntry->evaluationFunction != nullptr) {
+		s = materialEntry->evaluationFunction(board, materialEntry->strongSide);
+		s = color == materialEntry->strongSide ? s : -s;
+		evalTable.store(EvaluationEntry(board->getHash(), s));
+		return s;
 	}
 
-	// pawn/knight position
-	u8 pawnsOnFiles[2][8] = { 0 };
+	// material and piece-square values, kept up to date by the board
+	s += board->getMaterial(color) - board->getMaterial(oppColor);
+	Score positional = board->getPositionalScore(color) - board->getPositionalScore(oppColor);
+
+	// pawn structure
+	PawnEntry* pawnEntry = probePawnTable();
+	positional += color == Color::WHITE ? pawnEntry->score : -pawnEntry->score;
+	positional += color == Color::WHITE ? materialEntry->imbalance : -materialEntry->imbalance;
+
+	// the incremental terms alone are far outside the window, estimates are not stored
+	int lazyScore = scale(materialEntry, s + positional.taper(board->getGamePhase()));
+	if (lazyScore + sLazyMargin <= alpha || lazyScore - sLazyMargin >= beta) {
+		return lazyScore;
+	}
+
+	// mobility, threats and attacks on the king zone from the attack sets of the pieces
+	u64 occupancy[2] = { 0, 0 };
+	u64 occupancyByType[2][6] = { { 0 } };
 	for (int c = 0; c < 2; c++) {
-		int sign = color == c ? 1 : -1;
 		std::vector<Piece*>* pieces = board->getPieceList(c);
 		for (int i = 0; i < pieces->size(); i++) {
 			Piece* p = (*pieces)[i];
-			if (!p->alive)
-				continue;
-			switch (p->type) {
-			case Piece::Pawn:
-				s += sign * sPawnTable[c][p->square];
-				pawnsOnFiles[c][p->square & 7]++;
-				break;
-			case Piece::Knight:
-				s += sign * sKnightPositionalValueTable[p->square];
-				break;
+			if (p->alive) {
+				u64 bit = Bitboard::squareBit(Board::convert88To64Square(p->square));
+				occupancy[c] |= bit;
+				occupancyByType[c][p->type] |= bit;
 			}
 		}
 	}
 
-	// double, isolated, passed pawns
-	int pawnEval = 0;
-	for (int i = 0; i < 8; i++) {
-		for (int c = 0; c < 2; c++) {
-			int sign = color == c ? 1 : -1;
-			// double pawns
-			if (pawnsOnFiles[c][i] > 1) {
-				pawnEval -= sign;
+	for (int c = 0; c < 2; c++) {
+		int sign = color == c ? 1 : -1;
+		int opp = Color::invert(c);
+		Piece* oppKing = board->getKing(opp);
+		u64 kingZone = board->getPieceAttacks(oppKing) | Bitboard::squareBit(Board::convert88To64Square(oppKing->square));
+		int mobility = 0;
+		int threats = 0;
+		int kingZoneAttacks = 0;
+
+		std::vector<Piece*>* pieces = board->getPieceList(c);
+		for (int i = 0; i < pieces->size(); i++) {
+			Piece* p = (*pieces)[i];
+			if (!p->alive) {
+				continue;
 			}
-			// isolated pawns
-			if (pawnsOnFiles[c][i] > 0 && (i == 0 || pawnsOnFiles[c][i - 1] == 0) && (i == 7 || pawnsOnFiles[c][i + 1] == 0)) {
-				pawnEval -= sign;
+			u64 attacks = board->getPieceAttacks(p);
+
+			// dont count king/queen mobility
+			if (p->type != Piece::Queen && p->type != Piece::King && p->type != Piece::Pawn) {
+				mobility += Bitboard::popCount(attacks & ~occupancy[c]);
 			}
-			// passed
-			if (pawnsOnFiles[c][i] > 0 && pawnsOnFiles[c ^ 1][i] == 0 && (i == 0 || pawnsOnFiles[c ^ 1][i - 1] == 0) && (i == 7 || pawnsOnFiles[c ^ 1][i + 1] == 0)) {
-				pawnEval += 2 * sign;
+
+			// threats against more valuable pieces
+			u64 targets = 0;
+			for (int type = p->type + 1; type < 6; type++) {
+				targets |= occupancyByType[opp][type];
 			}
-		}
-	}
-	s += 3 * pawnEval;
-
-	// tempo
-	Move moves[128];
-	int n = board->generateMoves(color, moves);
-	for (int i = 0; i < n; i++) {
-		Move& m = moves[i];
-		if (m.capturedPiece != nullptr && m.capturedPiece->type > m.movingPiece->type) {
-			s += 3;
-		}
-		// dont count king/queen mobility
-		if (m.movingPiece->type == Piece::Queen || m.movingPiece->type == Piece::King) {
-			s--;
-		}
-	}
+			threats += Bitboard::popCount(attacks & targets);
 
-	int m = board->generateMoves(oppColor, moves);
-	for (int i = 0; i < m; i++) {
-		Move& m = moves[i];
-		if (m.capturedPiece != nullptr && m.capturedPiece->type > m.movingPiece->type) {
-			s -= 3;
-		}
-		// dont count king/queen mobility
-		if (m.movingPiece->type == Piece::Queen || m.movingPiece->type == Piece::King) {
-			s++;
+			kingZoneAttacks += sKingSafetyContribution[p->type] * Bitboard::popCount(attacks & kingZone);
 		}
+		positional += (sMobilityBonus * mobility + sThreatBonus * threats + sKingZoneAttackBonus * kingZoneAttacks) * sign;
 	}
-	// move count
-	s += (n - m);
 
 	// king safety
 	for (int c = 0; c < 2; c++) {
 		int sign = color == c ? 1 : -1;
+		int openSquares = 0;
 		Piece* king = board->getKing(c);
 		for (int i = 0; i < 8; i++) {
 			int sq = king->square + queenVectorMoves[i];
@@ -139,13 +128,95 @@ int DefaultEvaluator::evaluate() {
 				if ((hitPiece = board->getPiece(sq)) != nullptr && hitPiece->color == c) {
 					break;
 				}
-				s -= sign;
+				openSquares++;
 				sq += queenVectorMoves[i];
 			}
 		}
+		positional -= sOpenKingLinePenalty * (sign * openSquares);
 	}
 
+	s = scale(materialEntry, s + positional.taper(board->getGamePhase()));
+
 	evalTable.store(EvaluationEntry(board->getHash(), s));
 
 	return s;
+}
+
+// drawish material lowers the score of the side which is ahead
+int DefaultEvaluator::scale(MaterialEntry* materialEntry, int score) {
+	int side = score > 0 ? board->getColorToMove() : Color::invert(board->getColorToMove());
+	Endgame::ScalingFunction scalingFunction = materialEntry->scalingFunctions[side];
+	if (scalingFunction == nullptr) {
+		return score;
+	}
+	return score * scalingFunction(board, side) / Endgame::NORMAL_SCALE;
+}
+
+PawnEntry* DefaultEvaluator::probePawnTable() {
+	u64 key = board->getPawnHash();
+	PawnEntry* entry = pawnTable.find(key);
+	if (entry->hash == key) {
+		return entry;
+	}
+
+	u64 pawns[2] = { 0, 0 };
+	for (int c = 0; c < 2; c++) {
+		std::vector<Piece*>* pieces = board->getPieceList(c);
+		for (int i = 0; i < pieces->size(); i++) {
+			Piece* p = (*pieces)[i];
+			if (p->alive && p->type == Piece::Pawn) {
+				pawns[c] |= Bitboard::squareBit(Board::convert88To64Square(p->square));
+			}
+		}
+	}
+
+	entry->score = Score(0, 0);
+	for (int c = 0; c < 2; c++) {
+		u64 own = pawns[c];
+		u64 opp = pawns[Color::invert(c)];
+		u64 pushed = c == Color::WHITE ? Bitboard::shiftUp(own) : Bitboard::shiftDown(own);
+		Score s(0, 0);
+
+		entry->pawnAttacks[c] = Bitboard::shiftLeft(pushed) | Bitboard::shiftRight(pushed);
+		entry->passedPawns[c] = 0;
+		entry->pawnFiles[c] = 0;
+
+		// double pawns
+		for (int file = 0; file < 8; file++) {
+			int n = Bitboard::popCount(own & Bitboard::fileMask(file));
+			if (n > 0) {
+				entry->pawnFiles[c] |= 1 << file;
+			}
+			if (n > 1) {
+				s -= sDoubledPawnPenalty * (n - 1);
+			}
+		}
+
+		u64 b = own;
+		while (b != 0) {
+			int sq = Bitboard::popLsb(b);
+			int file = sq & 7;
+			u64 bit = Bitboard::squareBit(sq);
+			u64 front = Bitboard::forwardRanksMask(c, sq);
+
+			// isolated pawns
+			if ((own & Bitboard::adjacentFilesMask(file)) == 0) {
+				s -= sIsolatedPawnPenalty;
+			}
+			// passed pawns, only the front one of double pawns
+			if ((opp & front & (Bitboard::fileMask(file) | Bitboard::adjacentFilesMask(file))) == 0 && (own & front & Bitboard::fileMask(file)) == 0) {
+				entry->passedPawns[c] |= bit;
+				s += sPassedPawnBonus[c == Color::WHITE ? sq >> 3 : 7 - (sq >> 3)];
+			}
+			// protected pawns and pawns side by side
+			if ((entry->pawnAttacks[c] & bit) != 0 || ((Bitboard::shiftLeft(bit) | Bitboard::shiftRight(bit)) & own) != 0) {
+				s += sConnectedPawnBonus;
+			}
+		}
+
+		entry->score += c == Color::WHITE ? s : -s;
+	}
+	entry->hash = key;
+
+	return entry;
 }
\ No newline at end of file
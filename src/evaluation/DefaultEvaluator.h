@@ -3,17 +3,24 @@
 #include "../types.h"
 #include "../Board.h"
 #include "../hashing/EvaluationEntry.h"
+#include "../hashing/PawnEntry.h"
+#include "../hashing/MaterialEntry.h"
 #include "../hashing/HashTable.h"
 
-class DefaultEvaluator : public Evaluator
+class DefaultEvaluator final : public Evaluator
 {
 public:
 	static const int PIECE_WORTH[];
 
-	DefaultEvaluator(Board* board, u64 tableSize = 10000001);
+	DefaultEvaluator(Board* board, u64 tableSize = 10000001, u64 pawnTableSize = 100003);
 	int evaluate();
+	int evaluate(int alpha, int beta);
 private:
+	PawnEntry* probePawnTable();
+	int scale(MaterialEntry* materialEntry, int score);
+
 	Board* board;
 	HashTable<EvaluationEntry> evalTable;
+	HashTable<PawnEntry> pawnTable;
 };
 
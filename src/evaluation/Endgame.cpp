@@ -0,0 +1,169 @@
+#include "Endgame.h"
+#include "DefaultEvaluator.h"
+#include "../Board.h"
+#include "../DeltaTables.h"
+#include "../hashing/MaterialEntry.h"
+#include "KPKBitbase.h"
+
+#include <algorithm>
+
+static Piece* findPiece(Board* board, int color, Piece::PieceType type) {
+	std::vector<Piece*>* pieces = board->getPieceList(color);
+	for (int i = 0; i < pieces->size(); i++) {
+		Piece* p = (*pieces)[i];
+		if (p->alive && p->type == type) {
+			return p;
+		}
+	}
+	return nullptr;
+}
+
+static bool isDarkSquare(int square) {
+	return (((square & 7) + (square >> 4)) & 1) == 0;
+}
+
+// bonus for a king close to the edge of the board, highest in the corners
+static int pushToEdge(int square) {
+	int file = square & 7;
+	int rank = square >> 4;
+	return 20 * (6 - std::min(file, 7 - file) - std::min(rank, 7 - rank));
+}
+
+static int pushClose(int square1, int square2) {
+	return 10 * (7 - DeltaTables::getDistance(square1, square2));
+}
+
+void Endgame::classify(Board* board, MaterialEntry* entry) {
+	entry->evaluationFunction = nullptr;
+	entry->strongSide = Color::WHITE;
+	entry->scalingFunctions[0] = nullptr;
+	entry->scalingFunctions[1] = nullptr;
+
+	if (!entry->sufficientMaterial) {
+		entry->evaluationFunction = evaluateDraw;
+		return;
+	}
+
+	int pawns[2];
+	int pieceMaterial[2];
+	for (int c = 0; c < 2; c++) {
+		pawns[c] = board->getPieceCount(c, Piece::Pawn);
+		pieceMaterial[c] = 0;
+		for (int type = Piece::Knight; type <= Piece::Queen; type++) {
+			pieceMaterial[c] += board->getPieceCount(c, (Piece::PieceType)type) * DefaultEvaluator::PIECE_WORTH[type];
+		}
+	}
+
+	// lone king against mating material
+	for (int strong = 0; strong < 2; strong++) {
+		int weak = Color::invert(strong);
+		if (pawns[weak] + pieceMaterial[weak] > 0) {
+			continue;
+		}
+
+		if (pawns[strong] == 0 && board->getPieceCount(strong, Piece::Bishop) == 1 && board->getPieceCount(strong, Piece::Knight) == 1 &&
+			pieceMaterial[strong] == DefaultEvaluator::PIECE_WORTH[Piece::Bishop] + DefaultEvaluator::PIECE_WORTH[Piece::Knight]) {
+			entry->evaluationFunction = evaluateKBNK;
+		}
+		else if (pawns[strong] == 1 && pieceMaterial[strong] == 0) {
+			entry->evaluationFunction = evaluateKPK;
+		}
+		else if (pieceMaterial[strong] >= DefaultEvaluator::PIECE_WORTH[Piece::Rook]) {
+			entry->evaluationFunction = evaluateKXK;
+		}
+
+		if (entry->evaluationFunction != nullptr) {
+			entry->strongSide = strong;
+			return;
+		}
+	}
+
+	// one bishop each and pawns, the square colors are checked when evaluating
+	if (pieceMaterial[0] == DefaultEvaluator::PIECE_WORTH[Piece::Bishop] && pieceMaterial[1] == DefaultEvaluator::PIECE_WORTH[Piece::Bishop] &&
+		board->getPieceCount(Color::WHITE, Piece::Bishop) == 1 && board->getPieceCount(Color::BLACK, Piece::Bishop) == 1) {
+		entry->scalingFunctions[0] = scaleOppositeBishops;
+		entry->scalingFunctions[1] = scaleOppositeBishops;
+	}
+
+	// without pawns a small material advantage is not enough to win
+	for (int c = 0; c < 2; c++) {
+		if (pawns[c] == 0 && pieceMaterial[c] - pieceMaterial[Color::invert(c)] <= DefaultEvaluator::PIECE_WORTH[Piece::Bishop]) {
+			entry->scalingFunctions[c] = scaleNoPawns;
+		}
+	}
+}
+
+int Endgame::evaluateDraw(Board*, int) {
+	return 0;
+}
+
+int Endgame::evaluateKXK(Board* board, int strongSide) {
+	int strongKing = board->getKing(strongSide)->square;
+	int weakKing = board->getKing(Color::invert(strongSide))->square;
+
+	int score = board->getMaterial(strongSide) + pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+
+	// knights or bishops of one color can't force mate
+	bool lightBishop = false;
+	bool darkBishop = false;
+	std::vector<Piece*>* pieces = board->getPieceList(strongSide);
+	for (int i = 0; i < pieces->size(); i++) {
+		Piece* p = (*pieces)[i];
+		if (p->alive && p->type == Piece::Bishop) {
+			(isDarkSquare(p->square) ? darkBishop : lightBishop) = true;
+		}
+	}
+	if (board->getPieceCount(strongSide, Piece::Queen) > 0 || board->getPieceCount(strongSide, Piece::Rook) > 0 || board->getPieceCount(strongSide, Piece::Pawn) > 0 ||
+		(lightBishop && darkBishop) || ((lightBishop || darkBishop) && board->getPieceCount(strongSide, Piece::Knight) > 0)) {
+		score += KNOWN_WIN;
+	}
+	return score;
+}
+
+int Endgame::evaluateKBNK(Board* board, int strongSide) {
+	int strongKing = board->getKing(strongSide)->square;
+	int weakKing = board->getKing(Color::invert(strongSide))->square;
+
+	// mate is only possible in a corner of the bishop's color
+	Piece* bishop = findPiece(board, strongSide, Piece::Bishop);
+	int corner1 = isDarkSquare(bishop->square) ? 0x00 : 0x07;
+	int corner2 = isDarkSquare(bishop->square) ? 0x77 : 0x70;
+	int cornerDistance = std::min(DeltaTables::getDistance(weakKing, corner1), DeltaTables::getDistance(weakKing, corner2));
+
+	return KNOWN_WIN + board->getMaterial(strongSide) + 30 * (7 - cornerDistance) + pushClose(strongKing, weakKing);
+}
+
+int Endgame::evaluateKPK(Board* board, int strongSide) {
+	int strongKing = board->getKing(strongSide)->square;
+	int weakKing = board->getKing(Color::invert(strongSide))->square;
+	Piece* pawn = findPiece(board, strongSide, Piece::Pawn);
+
+	if (!KPKBitbase::probe(strongSide, strongKing, pawn->square, weakKing, board->getColorToMove())) {
+		return 0;
+	}
+	int rank = strongSide == Color::WHITE ? pawn->square >> 4 : 7 - (pawn->square >> 4);
+	return KNOWN_WIN + DefaultEvaluator::PIECE_WORTH[Piece::Pawn] + 20 * rank;
+}
+
+bool Endgame::isBitbaseDraw(Board* board, MaterialEntry* entry) {
+	return entry->evaluationFunction == evaluateKPK && evaluateKPK(board, entry->strongSide) == 0;
+}
+
+int Endgame::scaleOppositeBishops(Board* board, int) {
+	Piece* whiteBishop = findPiece(board, Color::WHITE, Piece::Bishop);
+	Piece* blackBishop = findPiece(board, Color::BLACK, Piece::Bishop);
+	if (isDarkSquare(whiteBishop->square) == isDarkSquare(blackBishop->square)) {
+		return NORMAL_SCALE;
+	}
+	return NORMAL_SCALE / 2;
+}
+
+int Endgame::scaleNoPawns(Board* board, int strongSide) {
+	int weakSide = Color::invert(strongSide);
+	int strongPieces = board->getMaterial(strongSide);
+	int weakPieces = board->getMaterial(weakSide) - board->getPieceCount(weakSide, Piece::Pawn) * DefaultEvaluator::PIECE_WORTH[Piece::Pawn];
+	if (strongPieces < DefaultEvaluator::PIECE_WORTH[Piece::Rook]) {
+		return 0;
+	}
+	return weakPieces <= DefaultEvaluator::PIECE_WORTH[Piece::Bishop] ? 4 : 14;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+class Board;
+class MaterialEntry;
+
+// Evaluation and scaling functions for endgames with special knowledge, picked by the material table.
+class Endgame
+{
+public:
+	// score from the strong side's point of view
+	typedef int (*EvaluationFunction)(Board* board, int strongSide);
+	// factor from 0 (draw) to NORMAL_SCALE applied to the evaluation when the strong side is ahead
+	typedef int (*ScalingFunction)(Board* board, int strongSide);
+
+	static const int NORMAL_SCALE = 64;
+	static const int KNOWN_WIN = 1000;
+
+	// sets the functions of a new material entry
+	static void classify(Board* board, MaterialEntry* entry);
+
+	static int evaluateDraw(Board* board, int strongSide);
+	static int evaluateKXK(Board* board, int strongSide);
+	static int evaluateKBNK(Board* board, int strongSide);
+	static int evaluateKPK(Board* board, int strongSide);
+
+	// true if the position is drawn according to a bitbase, entry is the material entry of the board
+	static bool isBitbaseDraw(Board* board, MaterialEntry* entry);
+
+	static int scaleOppositeBishops(Board* board, int strongSide);
+	static int scaleNoPawns(Board* board, int strongSide);
+};
\ No newline at end of file
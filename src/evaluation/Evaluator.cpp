@@ -3,4 +3,8 @@
 
 int Evaluator::evaluate() {
 	return rand() & 63;
+}
+
+int Evaluator::evaluate(int, int) {
+	return evaluate();
 }
\ No newline at end of file
@@ -4,6 +4,9 @@ class Evaluator
 {
 public:
 	Evaluator() = default;
+	virtual ~Evaluator() = default;
 	virtual int evaluate();
+	// may return an estimate if the position is clearly outside of [alpha, beta]
+	virtual int evaluate(int alpha, int beta);
 };
 
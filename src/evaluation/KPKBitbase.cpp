@@ -0,0 +1,173 @@
+#include "KPKBitbase.h"
+#include "../Color.h"
+#include "../Board.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+u32 KPKBitbase::bitbase[KPKBitbase::SIZE / 32];
+
+// bits, so the results of the successors can be combined with or
+static const u8 INVALID = 0;
+static const u8 UNKNOWN = 1;
+static const u8 DRAW = 2;
+static const u8 WIN = 4;
+
+static int file(int square) {
+	return square & 7;
+}
+
+static int rank(int square) {
+	return square >> 3;
+}
+
+static int distance(int square1, int square2) {
+	return std::max(std::abs(file(square1) - file(square2)), std::abs(rank(square1) - rank(square2)));
+}
+
+static bool isPawnAttack(int pawn, int square) {
+	return rank(square) == rank(pawn) + 1 && std::abs(file(square) - file(pawn)) == 1;
+}
+
+int KPKBitbase::getIndex(int colorToMove, int blackKing, int whiteKing, int pawn) {
+	return whiteKing | (blackKing << 6) | (colorToMove << 12) | (file(pawn) << 13) | ((6 - rank(pawn)) << 15);
+}
+
+// results of the positions which are decided without looking at the successors
+static u8 classifyInitial(int colorToMove, int whiteKing, int blackKing, int pawn) {
+	if (distance(whiteKing, blackKing) <= 1 || whiteKing == pawn || blackKing == pawn ||
+		(colorToMove == Color::WHITE && isPawnAttack(pawn, blackKing))) {
+		return INVALID;
+	}
+
+	// the pawn promotes safely
+	if (colorToMove == Color::WHITE && rank(pawn) == 6) {
+		int promotion = pawn + 8;
+		if (whiteKing != promotion && blackKing != promotion && (distance(blackKing, promotion) > 1 || distance(whiteKing, promotion) == 1)) {
+			return WIN;
+		}
+	}
+
+	if (colorToMove == Color::BLACK) {
+		// the pawn is lost
+		if (distance(blackKing, pawn) == 1 && distance(whiteKing, pawn) > 1) {
+			return DRAW;
+		}
+
+		// stalemate
+		bool canMove = false;
+		for (int dr = -1; dr <= 1 && !canMove; dr++) {
+			for (int df = -1; df <= 1; df++) {
+				int r = rank(blackKing) + dr;
+				int f = file(blackKing) + df;
+				if ((dr == 0 && df == 0) || r < 0 || r > 7 || f < 0 || f > 7) {
+					continue;
+				}
+				int sq = r * 8 + f;
+				if (distance(sq, whiteKing) > 1 && !isPawnAttack(pawn, sq)) {
+					canMove = true;
+					break;
+				}
+			}
+		}
+		if (!canMove) {
+			return DRAW;
+		}
+	}
+	return UNKNOWN;
+}
+
+void KPKBitbase::init() {
+	std::vector<u8> results(SIZE);
+
+	for (int idx = 0; idx < SIZE; idx++) {
+		int whiteKing = idx & 63;
+		int blackKing = (idx >> 6) & 63;
+		int colorToMove = (idx >> 12) & 1;
+		int pawn = ((6 - (idx >> 15)) << 3) | ((idx >> 13) & 3);
+		results[idx] = classifyInitial(colorToMove, whiteKing, blackKing, pawn);
+	}
+
+	// white wins if any move wins, black draws if any move draws, repeat until nothing changes
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int idx = 0; idx < SIZE; idx++) {
+			if (results[idx] != UNKNOWN) {
+				continue;
+			}
+			int whiteKing = idx & 63;
+			int blackKing = (idx >> 6) & 63;
+			int colorToMove = (idx >> 12) & 1;
+			int pawn = ((6 - (idx >> 15)) << 3) | ((idx >> 13) & 3);
+
+			int movingKing = colorToMove == Color::WHITE ? whiteKing : blackKing;
+			int successors = 0;
+			for (int dr = -1; dr <= 1; dr++) {
+				for (int df = -1; df <= 1; df++) {
+					int r = rank(movingKing) + dr;
+					int f = file(movingKing) + df;
+					if ((dr == 0 && df == 0) || r < 0 || r > 7 || f < 0 || f > 7) {
+						continue;
+					}
+					int sq = r * 8 + f;
+					successors |= colorToMove == Color::WHITE ?
+						results[getIndex(Color::BLACK, blackKing, sq, pawn)] :
+						results[getIndex(Color::WHITE, sq, whiteKing, pawn)];
+				}
+			}
+
+			// pawn pushes, the promotion itself is decided by the initial classification
+			if (colorToMove == Color::WHITE && rank(pawn) < 6) {
+				int push = pawn + 8;
+				if (push != whiteKing && push != blackKing) {
+					successors |= results[getIndex(Color::BLACK, blackKing, whiteKing, push)];
+					if (rank(pawn) == 1 && push + 8 != whiteKing && push + 8 != blackKing) {
+						successors |= results[getIndex(Color::BLACK, blackKing, whiteKing, push + 8)];
+					}
+				}
+			}
+
+			u8 good = colorToMove == Color::WHITE ? WIN : DRAW;
+			u8 bad = colorToMove == Color::WHITE ? DRAW : WIN;
+			u8 result = (successors & good) ? good : (successors & UNKNOWN) ? UNKNOWN : bad;
+			if (result != UNKNOWN) {
+				results[idx] = result;
+				changed = true;
+			}
+		}
+	}
+
+	std::fill(bitbase, bitbase + SIZE / 32, 0);
+	for (int idx = 0; idx < SIZE; idx++) {
+		if (results[idx] == WIN) {
+			bitbase[idx >> 5] |= 1u << (idx & 31);
+		}
+	}
+}
+
+bool KPKBitbase::probeWhiteWins(int whiteKing, int whitePawn, int blackKing, int colorToMove) {
+	int idx = getIndex(colorToMove, blackKing, whiteKing, whitePawn);
+	return (bitbase[idx >> 5] & (1u << (idx & 31))) != 0;
+}
+
+bool KPKBitbase::probe(int strongSide, int strongKing, int pawn, int weakKing, int colorToMove) {
+	int whiteKing = Board::convert88To64Square(strongKing);
+	int whitePawn = Board::convert88To64Square(pawn);
+	int blackKing = Board::convert88To64Square(weakKing);
+
+	// the table is built for a white pawn on the files a-d
+	if (strongSide == Color::BLACK) {
+		whiteKing ^= 56;
+		whitePawn ^= 56;
+		blackKing ^= 56;
+		colorToMove = Color::invert(colorToMove);
+	}
+	if (file(whitePawn) >= 4) {
+		whiteKing ^= 7;
+		whitePawn ^= 7;
+		blackKing ^= 7;
+	}
+	return probeWhiteWins(whiteKing, whitePawn, blackKing, colorToMove);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "../types.h"
+
+// Win/draw table of all king and pawn against king positions, computed by retrograde analysis.
+// Squares are 0..63 (a1 = 0), positions are seen with white as the side having the pawn.
+class KPKBitbase
+{
+public:
+	// has to be called once before probing, takes a few milliseconds
+	static void init();
+	static bool probeWhiteWins(int whiteKing, int whitePawn, int blackKing, int colorToMove);
+	// any side and any pawn file, squares on the 0x88 board
+	static bool probe(int strongSide, int strongKing, int pawn, int weakKing, int colorToMove);
+private:
+	// white king, black king, side to move, pawn file a-d and pawn rank 2-7
+	static const int SIZE = 64 * 64 * 2 * 4 * 6;
+
+	static int getIndex(int colorToMove, int blackKing, int whiteKing, int pawn);
+
+	static u32 bitbase[SIZE / 32];
+};
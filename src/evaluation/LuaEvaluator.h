@@ -6,10 +6,11 @@
 #include "../hashing/EvaluationEntry.h"
 #include "../hashing/HashTable.h"
 
-class LuaEvaluator : public Evaluator
+class LuaEvaluator final : public Evaluator
 {
 public:
 	LuaEvaluator(Board* board, lua_State* luaState, u64 tableSize = 1000001);
+	using Evaluator::evaluate;
 	int evaluate();
 private:
 	Board* board;
@@ -0,0 +1,35 @@
+#include "MaterialTable.h"
+#include "../Board.h"
+#include "Endgame.h"
+
+static const Score sBishopPairBonus(30, 50);
+
+MaterialTable::MaterialTable(u64 tableSize) : table(tableSize, "material") {
+}
+
+MaterialEntry* MaterialTable::probe(Board* board) {
+	u64 key = board->getMaterialKey();
+	MaterialEntry* entry = table.find(key);
+	if (entry->hash == key) {
+		return entry;
+	}
+
+	entry->sufficientMaterial = false;
+	entry->imbalance = Score(0, 0);
+	for (int c = 0; c < 2; c++) {
+		int bishops = board->getPieceCount(c, Piece::Bishop);
+		int knights = board->getPieceCount(c, Piece::Knight);
+		if (board->getPieceCount(c, Piece::Rook) > 0 || board->getPieceCount(c, Piece::Queen) > 0 || board->getPieceCount(c, Piece::Pawn) > 0 ||
+			bishops > 1 || (bishops > 0 && knights > 0)) {
+			entry->sufficientMaterial = true;
+		}
+		if (bishops > 1) {
+			entry->imbalance += c == Color::WHITE ? sBishopPairBonus : -sBishopPairBonus;
+		}
+	}
+
+	Endgame::classify(board, entry);
+	entry->hash = key;
+
+	return entry;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "../types.h"
+#include "../hashing/HashTable.h"
+#include "../hashing/MaterialEntry.h"
+
+class Board;
+
+// Caches everything that only depends on the piece counts, indexed by the material key of the board.
+class MaterialTable
+{
+public:
+	MaterialTable(u64 tableSize = 8191);
+	MaterialEntry* probe(Board* board);
+private:
+	HashTable<MaterialEntry> table;
+};
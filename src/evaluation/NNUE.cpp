@@ -0,0 +1,250 @@
+#include "NNUE.h"
+#include "../Board.h"
+#include "../Move.h"
+#include "../Color.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NNUE_USE_AVX2
+#elif defined(__SSSE3__) || defined(__AVX__)
+// msvc never defines __SSSE3__, /arch:AVX implies it
+#include <tmmintrin.h>
+#define NNUE_USE_SSSE3
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NNUE_USE_SSE2
+#endif
+
+// offsets of the piece types in a feature block of one king square, the enemy pieces follow 64 entries later
+static const int sPieceOffset[] = { 0, 1, 1 + 2 * 64, 1 + 4 * 64, 1 + 6 * 64, 1 + 8 * 64 };
+static const int sFeatureBlockSize = 641;
+static const int sWeightScaleBits = 6;
+
+template <class T>
+static bool readValues(std::ifstream& in, std::vector<T>& values, size_t count) {
+	values.resize(count);
+	in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+	return in.good();
+}
+
+template <class T>
+static void fillRandom(std::mt19937& random, std::vector<T>& values, size_t count, int range) {
+	values.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		values[i] = (T)((int)(random() % (2 * range + 1)) - range);
+	}
+}
+
+static bool readU32(std::ifstream& in, u32& value) {
+	in.read(reinterpret_cast<char*>(&value), sizeof(u32));
+	return in.good();
+}
+
+// sum of input[i] * weights[i], n has to be a multiple of 32 and the inputs must not exceed 127
+static int32_t dotProduct(const u8* input, const int8_t* weights, int n) {
+#if defined(NNUE_USE_AVX2)
+	const __m256i ones = _mm256_set1_epi16(1);
+	__m256i sum = _mm256_setzero_si256();
+	for (int i = 0; i < n; i += 32) {
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+	}
+	__m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+	return _mm_cvtsi128_si32(s);
+#elif defined(NNUE_USE_SSSE3)
+	const __m128i ones = _mm_set1_epi16(1);
+	__m128i sum = _mm_setzero_si128();
+	for (int i = 0; i < n; i += 16) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+	return _mm_cvtsi128_si32(sum);
+#else
+	int32_t sum = 0;
+	for (int i = 0; i < n; i++) {
+		sum += input[i] * weights[i];
+	}
+	return sum;
+#endif
+}
+
+// dense layer followed by a clipped ReLU
+static void propagate(const u8* input, int inputSize, const std::vector<int32_t>& biases, const std::vector<int8_t>& weights, int outputSize, u8* output) {
+	for (int i = 0; i < outputSize; i++) {
+		int32_t sum = biases[i] + dotProduct(input, &weights[(size_t)i * inputSize], inputSize);
+		output[i] = (u8)std::max(0, std::min(127, sum >> sWeightScaleBits));
+	}
+}
+
+bool NNUENetwork::load(std::string filename) {
+	std::ifstream in(filename, std::ios::binary);
+	if (!in.is_open()) {
+		return false;
+	}
+
+	u32 version, hash, size;
+	if (!readU32(in, version) || version != FILE_VERSION || !readU32(in, hash) || !readU32(in, size)) {
+		return false;
+	}
+	description.resize(size);
+	in.read(&description[0], size);
+
+	// the hashes of the layer headers are not checked, the file size is
+	bool ok = readU32(in, hash) &&
+		readValues(in, featureBiases, NNUEAccumulator::SIZE) &&
+		readValues(in, featureWeights, (size_t)FEATURES * NNUEAccumulator::SIZE) &&
+		readU32(in, hash) &&
+		readValues(in, l1Biases, L1_SIZE) &&
+		readValues(in, l1Weights, L1_SIZE * 2 * NNUEAccumulator::SIZE) &&
+		readValues(in, l2Biases, L2_SIZE) &&
+		readValues(in, l2Weights, L2_SIZE * L1_SIZE) &&
+		readValues(in, outputBias, 1) &&
+		readValues(in, outputWeights, L2_SIZE);
+
+	return ok && in.peek() == std::ifstream::traits_type::eof();
+}
+
+void NNUENetwork::initRandom(u32 seed) {
+	std::mt19937 random(seed);
+	description = "random network";
+	fillRandom(random, featureBiases, NNUEAccumulator::SIZE, 64);
+	fillRandom(random, featureWeights, (size_t)FEATURES * NNUEAccumulator::SIZE, 64);
+	fillRandom(random, l1Biases, L1_SIZE, 1024);
+	fillRandom(random, l1Weights, L1_SIZE * 2 * NNUEAccumulator::SIZE, 32);
+	fillRandom(random, l2Biases, L2_SIZE, 1024);
+	fillRandom(random, l2Weights, L2_SIZE * L1_SIZE, 32);
+	fillRandom(random, outputBias, 1, 1024);
+	fillRandom(random, outputWeights, L2_SIZE, 32);
+}
+
+std::string NNUENetwork::getDescription() {
+	return description;
+}
+
+int NNUENetwork::getFeatureIndex(int perspective, int kingSquare, int color, Piece::PieceType type, int square) {
+	// black sees the board rotated
+	int orientation = perspective == Color::WHITE ? 0 : 63;
+	int piece = sPieceOffset[type] + (color == perspective ? 0 : 64);
+	return (square ^ orientation) + piece + sFeatureBlockSize * (kingSquare ^ orientation);
+}
+
+void NNUENetwork::refreshAccumulator(Board* board, NNUEAccumulator& accumulator, int perspective) {
+	int16_t* values = accumulator.values[perspective];
+	memcpy(values, featureBiases.data(), sizeof(int16_t) * NNUEAccumulator::SIZE);
+
+	int kingSquare = Board::convert88To64Square(board->getKing(perspective)->square);
+	for (int c = 0; c < 2; c++) {
+		std::vector<Piece*>* pieces = board->getPieceList(c);
+		for (int i = 0; i < pieces->size(); i++) {
+			Piece* p = (*pieces)[i];
+			if (p->alive && p->type != Piece::King) {
+				addFeature(values, getFeatureIndex(perspective, kingSquare, c, p->type, Board::convert88To64Square(p->square)));
+			}
+		}
+	}
+}
+
+// has to be called after the move was made on the board
+void NNUENetwork::updateAccumulator(Board* board, NNUEAccumulator& accumulator, Move& move) {
+	for (int perspective = 0; perspective < 2; perspective++) {
+		// all features depend on the own king
+		if (move.color == perspective && move.movingPiece->type == Piece::King) {
+			refreshAccumulator(board, accumulator, perspective);
+			continue;
+		}
+
+		int16_t* values = accumulator.values[perspective];
+		int kingSquare = Board::convert88To64Square(board->getKing(perspective)->square);
+
+		if (move.castlingMove != Move::None) {
+			removeFeature(values, getFeatureIndex(perspective, kingSquare, move.color, Piece::Rook, Board::convert88To64Square(move.castleRookSource)));
+			addFeature(values, getFeatureIndex(perspective, kingSquare, move.color, Piece::Rook, Board::convert88To64Square(move.castleRookDestination)));
+			continue;
+		}
+
+		if (move.movingPiece->type != Piece::King) {
+			Piece::PieceType newType = move.movingPiece->type;
+			Piece::PieceType oldType = move.promotionType != Piece::None ? Piece::Pawn : newType;
+			removeFeature(values, getFeatureIndex(perspective, kingSquare, move.color, oldType, Board::convert88To64Square(move.source)));
+			addFeature(values, getFeatureIndex(perspective, kingSquare, move.color, newType, Board::convert88To64Square(move.destination)));
+		}
+
+		if (move.capturedPiece != nullptr) {
+			Piece* captured = move.capturedPiece;
+			removeFeature(values, getFeatureIndex(perspective, kingSquare, captured->color, captured->type, Board::convert88To64Square(captured->square)));
+		}
+	}
+}
+
+int NNUENetwork::evaluate(NNUEAccumulator& accumulator, int color) {
+	u8 transformed[2 * NNUEAccumulator::SIZE];
+	u8 l1Output[L1_SIZE];
+	u8 l2Output[L2_SIZE];
+
+	// side to move first
+	int perspectives[2] = { color, Color::invert(color) };
+	for (int p = 0; p < 2; p++) {
+		int16_t* values = accumulator.values[perspectives[p]];
+		u8* out = transformed + p * NNUEAccumulator::SIZE;
+		for (int i = 0; i < NNUEAccumulator::SIZE; i++) {
+			out[i] = (u8)std::max(0, std::min(127, (int)values[i]));
+		}
+	}
+
+	propagate(transformed, 2 * NNUEAccumulator::SIZE, l1Biases, l1Weights, L1_SIZE, l1Output);
+	propagate(l1Output, L1_SIZE, l2Biases, l2Weights, L2_SIZE, l2Output);
+	int32_t output = outputBias[0] + dotProduct(l2Output, outputWeights.data(), L2_SIZE);
+
+	return output * 100 / OUTPUT_SCALE;
+}
+
+void NNUENetwork::addFeature(int16_t* values, int feature) {
+	const int16_t* weights = &featureWeights[(size_t)feature * NNUEAccumulator::SIZE];
+#if defined(NNUE_USE_AVX2)
+	for (int i = 0; i < NNUEAccumulator::SIZE; i += 16) {
+		__m256i* v = reinterpret_cast<__m256i*>(values + i);
+		_mm256_storeu_si256(v, _mm256_add_epi16(_mm256_loadu_si256(v), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+	}
+#elif defined(NNUE_USE_SSE2)
+	for (int i = 0; i < NNUEAccumulator::SIZE; i += 8) {
+		__m128i* v = reinterpret_cast<__m128i*>(values + i);
+		_mm_storeu_si128(v, _mm_add_epi16(_mm_loadu_si128(v), _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+	}
+#else
+	for (int i = 0; i < NNUEAccumulator::SIZE; i++) {
+		values[i] += weights[i];
+	}
+#endif
+}
+
+void NNUENetwork::removeFeature(int16_t* values, int feature) {
+	const int16_t* weights = &featureWeights[(size_t)feature * NNUEAccumulator::SIZE];
+#if defined(NNUE_USE_AVX2)
+	for (int i = 0; i < NNUEAccumulator::SIZE; i += 16) {
+		__m256i* v = reinterpret_cast<__m256i*>(values + i);
+		_mm256_storeu_si256(v, _mm256_sub_epi16(_mm256_loadu_si256(v), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+	}
+#elif defined(NNUE_USE_SSE2)
+	for (int i = 0; i < NNUEAccumulator::SIZE; i += 8) {
+		__m128i* v = reinterpret_cast<__m128i*>(values + i);
+		_mm_storeu_si128(v, _mm_sub_epi16(_mm_loadu_si128(v), _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+	}
+#else
+	for (int i = 0; i < NNUEAccumulator::SIZE; i++) {
+		values[i] -= weights[i];
+	}
+#endif
+}
\ No newline at end of file
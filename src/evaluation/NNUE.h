@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../types.h"
+#include "../Piece.h"
+
+class Board;
+class Move;
+
+// First layer outputs of both perspectives, indexed by color.
+// The board keeps one accumulator per ply and updates it in makeMove/unmakeMove.
+struct NNUEAccumulator
+{
+	static const int SIZE = 256;
+
+	int16_t values[2][SIZE];
+};
+
+// Quantized HalfKP network (41024 -> 2x256 -> 32 -> 32 -> 1) in the .nnue file format of Stockfish 12.
+// Features are (own king square, piece, square) triples seen from each side. Kings are not features themselves.
+class NNUENetwork
+{
+public:
+	static const u32 FILE_VERSION = 0x7AF32F16;
+	static const int FEATURES = 64 * 641;
+
+	NNUENetwork() = default;
+
+	bool load(std::string filename);
+	// small random weights, enough to test the accumulator updates without a network file
+	void initRandom(u32 seed);
+	std::string getDescription();
+
+	void refreshAccumulator(Board* board, NNUEAccumulator& accumulator, int perspective);
+	void updateAccumulator(Board* board, NNUEAccumulator& accumulator, Move& move);
+	int evaluate(NNUEAccumulator& accumulator, int color);
+
+	static int getFeatureIndex(int perspective, int kingSquare, int color, Piece::PieceType type, int square);
+private:
+	void addFeature(int16_t* values, int feature);
+	void removeFeature(int16_t* values, int feature);
+
+	static const int L1_SIZE = 32;
+	static const int L2_SIZE = 32;
+	// the network outputs 16 units per internal pawn value of 208
+	static const int OUTPUT_SCALE = 16 * 208;
+
+	std::string description;
+
+	std::vector<int16_t> featureBiases;
+	std::vector<int16_t> featureWeights;
+	std::vector<int32_t> l1Biases;
+	std::vector<int8_t> l1Weights;
+	std::vector<int32_t> l2Biases;
+	std::vector<int8_t> l2Weights;
+	std::vector<int32_t> outputBias;
+	std::vector<int8_t> outputWeights;
+};
+
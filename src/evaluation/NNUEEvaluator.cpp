@@ -0,0 +1,25 @@
+#include "NNUEEvaluator.h"
+
+NNUEEvaluator::NNUEEvaluator(Board* board, NNUENetwork* network, u64 tableSize) : evalTable(tableSize) {
+	this->board = board;
+	this->network = network;
+	board->setNNUENetwork(network);
+}
+
+NNUEEvaluator::~NNUEEvaluator() {
+	board->setNNUENetwork(nullptr);
+	delete network;
+}
+
+int NNUEEvaluator::evaluate() {
+	EvaluationEntry* evalEntry = evalTable.find(board->getHash());
+	if (evalEntry->hash == board->getHash()) {
+		return evalEntry->score;
+	}
+
+	int s = network->evaluate(board->getAccumulator(), board->getColorToMove());
+
+	evalTable.store(EvaluationEntry(board->getHash(), s));
+
+	return s;
+}
\ No newline at end of file
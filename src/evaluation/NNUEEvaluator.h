@@ -0,0 +1,22 @@
+#pragma once
+#include "Evaluator.h"
+#include "NNUE.h"
+#include "../types.h"
+#include "../Board.h"
+#include "../hashing/EvaluationEntry.h"
+#include "../hashing/HashTable.h"
+
+// Evaluates with a network whose accumulators are kept up to date by the board.
+// Takes ownership of the network.
+class NNUEEvaluator final : public Evaluator
+{
+public:
+	NNUEEvaluator(Board* board, NNUENetwork* network, u64 tableSize = 1000001);
+	~NNUEEvaluator();
+	using Evaluator::evaluate;
+	int evaluate();
+private:
+	Board* board;
+	NNUENetwork* network;
+	HashTable<EvaluationEntry> evalTable;
+};
\ No newline at end of file
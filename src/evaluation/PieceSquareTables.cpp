@@ -0,0 +1,82 @@
+#include "PieceSquareTables.h"
+#include "../Color.h"
+
+const int PieceSquareTables::PHASE_WEIGHT[] = { 0, 0, 1, 1, 2, 4 };
+
+// all tables are from white's point of view
+static constexpr int sPawnMidgameTable[] =
+{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+  3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+  5, 5, 5, 5, 5, 5, 5, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+  6, 6, 6, 6, 6, 6, 6, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static constexpr int sPawnEndgameTable[] =
+{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+  7, 7, 7, 7, 7, 7, 7, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+  11, 11, 11, 11, 11, 11, 11, 11, 0, 0, 0, 0, 0, 0, 0, 0,
+  16, 16, 16, 16, 16, 16, 16, 16, 0, 0, 0, 0, 0, 0, 0, 0,
+  22, 22, 22, 22, 22, 22, 22, 22, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static constexpr int sKnightPositionalValueTable[] =
+{ 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 3, 4, 4, 4, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 3, 4, 5, 5, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 3, 4, 5, 5, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 3, 4, 4, 4, 4, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
+static constexpr int sKingMidgameTable[] =
+{ 4, 6, 2, 0, 0, 2, 6, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, -2, -4, -4, -2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, 0, 0, 0, 0, 0 };
+static constexpr int sKingEndgameTable[] =
+{ -12, -8, -6, -4, -4, -6, -8, -12, 0, 0, 0, 0, 0, 0, 0, 0,
+  -8, -2, 0, 2, 2, 0, -2, -8, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, 0, 4, 6, 6, 4, 0, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -4, 2, 6, 8, 8, 6, 2, -4, 0, 0, 0, 0, 0, 0, 0, 0,
+  -4, 2, 6, 8, 8, 6, 2, -4, 0, 0, 0, 0, 0, 0, 0, 0,
+  -6, 0, 4, 6, 6, 4, 0, -6, 0, 0, 0, 0, 0, 0, 0, 0,
+  -8, -2, 0, 2, 2, 0, -2, -8, 0, 0, 0, 0, 0, 0, 0, 0,
+  -12, -8, -6, -4, -4, -6, -8, -12, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static constexpr int sEmptyPositionalValueTable[128] = { 0 };
+
+// indexed by piece type
+static constexpr const int* sMidgameTables[] = { sKingMidgameTable, sPawnMidgameTable, sKnightPositionalValueTable, sEmptyPositionalValueTable, sEmptyPositionalValueTable, sEmptyPositionalValueTable };
+static constexpr const int* sEndgameTables[] = { sKingEndgameTable, sPawnEndgameTable, sKnightPositionalValueTable, sEmptyPositionalValueTable, sEmptyPositionalValueTable, sEmptyPositionalValueTable };
+
+struct PackedTables
+{
+	Score values[2][6][128];
+};
+
+// packs the middlegame and endgame tables of both colors, black looks them up with the rank mirrored
+static constexpr PackedTables generatePackedTables() {
+	PackedTables tables = {};
+	for (int color = 0; color < 2; color++) {
+		for (int type = 0; type < 6; type++) {
+			for (int square = 0; square < 128; square++) {
+				int source = color == Color::BLACK ? square ^ 0x70 : square;
+				tables.values[color][type][square] = Score(sMidgameTables[type][source], sEndgameTables[type][source]);
+			}
+		}
+	}
+	return tables;
+}
+
+static constexpr PackedTables sPackedTables = generatePackedTables();
+
+Score PieceSquareTables::getValue(int color, Piece::PieceType type, int square) {
+	return sPackedTables.values[color][type][square];
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include "../Piece.h"
+#include "Score.h"
+
+// Positional values of the pieces on the 0x88 board for the middlegame and the endgame.
+// The board keeps the sums of these values and the game phase up to date in makeMove/unmakeMove.
+class PieceSquareTables
+{
+public:
+	// contribution of each piece type to the game phase, indexed by piece type
+	static const int PHASE_WEIGHT[];
+
+	static Score getValue(int color, Piece::PieceType type, int square);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+// A middlegame and an endgame value packed into one integer, so both are added up with a single instruction.
+// The endgame value lives in the upper 16 bits, the middlegame value in the lower 16 bits.
+class Score
+{
+public:
+	// game phase of the starting position, 0 is a pawn ending
+	static const int MAX_PHASE = 24;
+
+	Score() = default;
+	constexpr Score(int midgame, int endgame) : value((int)((unsigned int)endgame << 16) + midgame) {}
+
+	int midgame() const {
+		return (short)(unsigned short)(unsigned int)value;
+	}
+
+	int endgame() const {
+		return (short)(unsigned short)((unsigned int)(value + 0x8000) >> 16);
+	}
+
+	// interpolates between the endgame (phase 0) and middlegame (MAX_PHASE) value
+	int taper(int phase) const {
+		if (phase > MAX_PHASE) {
+			phase = MAX_PHASE;
+		}
+		return (midgame() * phase + endgame() * (MAX_PHASE - phase)) / MAX_PHASE;
+	}
+
+	Score operator+(Score other) const { return fromRaw(value + other.value); }
+	Score operator-(Score other) const { return fromRaw(value - other.value); }
+	Score operator-() const { return fromRaw(-value); }
+	Score operator*(int factor) const { return fromRaw(value * factor); }
+	Score& operator+=(Score other) { value += other.value; return *this; }
+	Score& operator-=(Score other) { value -= other.value; return *this; }
+	bool operator==(Score other) const { return value == other.value; }
+	bool operator!=(Score other) const { return value != other.value; }
+
+private:
+	static Score fromRaw(int raw) {
+		Score s;
+		s.value = raw;
+		return s;
+	}
+
+	int value;
+};
+
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <fstream>
+#include <algorithm>
 #include "../types.h"
 #include "../Move.h"
 #include "TableEntry.h"
@@ -31,6 +32,22 @@ public:
 		return &entries[hash % capacity];
 	}
 
+	void clear() {
+		std::fill(entries, entries + capacity, T());
+	}
+
+	// used entries per mille, sampled from the start of the table
+	int getUsage() {
+		u64 samples = capacity < 1000 ? capacity : 1000;
+		int used = 0;
+		for (u64 i = 0; i < samples; i++) {
+			if (entries[i].hash != 0) {
+				used++;
+			}
+		}
+		return (int)(used * 1000 / samples);
+	}
+
 	void dumpToFile(std::string filename) {
 		std::ofstream fs;
 		fs.open(filename);
@@ -0,0 +1,5 @@
+#include "MaterialEntry.h"
+
+void MaterialEntry::dumpToStream(std::ostream& stream) {
+	stream << " { imbalance: " << imbalance.midgame() << "/" << imbalance.endgame() << ", sufficient: " << sufficientMaterial << ", endgame: " << (evaluationFunction != nullptr) << ", scaled: " << (scalingFunctions[0] != nullptr) << "/" << (scalingFunctions[1] != nullptr) << " } " << std::endl;
+}
\ No newline at end of file
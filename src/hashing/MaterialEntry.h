@@ -0,0 +1,22 @@
+#pragma once
+#include "../types.h"
+#include "TableEntry.h"
+#include "../evaluation/Score.h"
+#include "../evaluation/Endgame.h"
+
+class MaterialEntry : public TableEntry
+{
+public:
+	MaterialEntry() = default;
+	~MaterialEntry() = default;
+
+	void dumpToStream(std::ostream& stream);
+
+	Score imbalance; // from white's point of view
+	bool sufficientMaterial;
+	// replaces the normal evaluation if set, the score is from the strong side's point of view
+	Endgame::EvaluationFunction evaluationFunction;
+	u8 strongSide;
+	// scales the evaluation down if the indexed side is ahead, nullptr for normal material
+	Endgame::ScalingFunction scalingFunctions[2];
+};
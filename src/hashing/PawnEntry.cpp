@@ -0,0 +1,5 @@
+#include "PawnEntry.h"
+
+void PawnEntry::dumpToStream(std::ostream& stream) {
+	stream << " { score: " << score.midgame() << "/" << score.endgame() << ", passed: " << passedPawns[0] << "/" << passedPawns[1] << ", files: " << (int)pawnFiles[0] << "/" << (int)pawnFiles[1] << " } " << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include "../types.h"
+#include "TableEntry.h"
+#include "../evaluation/Score.h"
+
+class PawnEntry : public TableEntry
+{
+public:
+	PawnEntry() = default;
+	~PawnEntry() = default;
+
+	void dumpToStream(std::ostream& stream);
+
+	Score score; // from white's point of view
+	u64 passedPawns[2];
+	u64 pawnAttacks[2];
+	u8 pawnFiles[2];
+};
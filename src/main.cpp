@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <cstring>
 
 #include "Configuration.h"
 #include "Engine.h"
@@ -15,6 +16,7 @@ int main(int argc, char* argv[])
 	bool selfPlay = false;
 	bool runUCI = true;
 	bool testEval = false;
+	std::string tablebase = "";
 
 	int time = 1000;
 	int increment = -1;
@@ -36,6 +38,13 @@ int main(int argc, char* argv[])
 				fen = std::string(argv[i]);
 			}
 		}
+		else if (strcmp(argv[i], "-g") == 0) {
+			runUCI = false;
+			i++;
+			if (i < argc) {
+				tablebase = std::string(argv[i]);
+			}
+		}
 		else if (strcmp(argv[i], "-s") == 0) {
 			selfPlay = true;
 			runUCI = false;
@@ -55,6 +64,9 @@ int main(int argc, char* argv[])
 	if (testEval) {
 		engine.evaluatePosition(fen);
 	}
+	if (!tablebase.empty()) {
+		engine.generateTablebase(tablebase);
+	}
 	if (selfPlay) {
 		engine.playSelf(increment == -1 ? ClockHandler::MOVETIME : ClockHandler::NORMAL, increment == -1 ? time : 60 * time, increment < 0 ? 0 : increment);
 	}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include "../types.h"
+
+// Read only memory mapping of a file, the pages are loaded by the OS on first access.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(std::string filename);
+	void close();
+	const u8* getData();
+	u64 getSize();
+private:
+	const u8* data;
+	u64 size;
+#ifdef _WIN32
+	void* file; // HANDLE
+	void* mapping;
+#endif
+};
@@ -0,0 +1,148 @@
+#include "Tablebase.h"
+#include "../Color.h"
+#include "../evaluation/DefaultEvaluator.h"
+
+static const char sPieceChars[] = { 'K', 'P', 'N', 'B', 'R', 'Q' };
+
+static int to64(int square) {
+	return ((square >> 4) << 3) | (square & 7);
+}
+
+static int to88(int square) {
+	return ((square >> 3) << 4) | (square & 7);
+}
+
+// material of one side without the king, strongest pieces first
+static std::string getMaterialString(const TablebasePosition& position, int color) {
+	std::string material;
+	for (int type = Piece::Queen; type >= Piece::Knight; type--) {
+		for (int i = 0; i < position.numPieces; i++) {
+			if (position.colors[i] == color && position.types[i] == type) {
+				material += sPieceChars[type];
+			}
+		}
+	}
+	return material;
+}
+
+static int getMaterialWorth(const TablebasePosition& position, int color) {
+	int worth = 0;
+	for (int i = 0; i < position.numPieces; i++) {
+		if (position.colors[i] == color) {
+			worth += DefaultEvaluator::PIECE_WORTH[position.types[i]];
+		}
+	}
+	return worth;
+}
+
+u64 Tablebase::getSize(int numPieces) {
+	u64 size = 2 * 16;
+	for (int i = 1; i < numPieces; i++) {
+		size *= 64;
+	}
+	return size;
+}
+
+std::string Tablebase::getName(const TablebasePosition& position) {
+	return "K" + getMaterialString(position, Color::WHITE) + "vK" + getMaterialString(position, Color::BLACK);
+}
+
+bool Tablebase::parseName(std::string name, TablebasePosition& position) {
+	position.numPieces = 0;
+	position.colorToMove = Color::WHITE;
+	int color = -1;
+	for (int i = 0; i < name.size(); i++) {
+		char c = name[i];
+		if (c == 'v') {
+			continue;
+		}
+		if (c == 'K') {
+			color++;
+		}
+		Piece::PieceType type = Piece::None;
+		for (int t = 0; t < 6; t++) {
+			if (sPieceChars[t] == c && t != Piece::Pawn) {
+				type = (Piece::PieceType)t;
+			}
+		}
+		if (type == Piece::None || color < 0 || color > 1 || position.numPieces == TablebasePosition::MAX_PIECES) {
+			return false;
+		}
+		position.colors[position.numPieces] = color;
+		position.types[position.numPieces] = type;
+		position.squares[position.numPieces] = 0;
+		position.numPieces++;
+	}
+	if (color != 1) {
+		return false;
+	}
+	normalize(position);
+	return true;
+}
+
+void Tablebase::normalize(TablebasePosition& position) {
+	std::string white = getMaterialString(position, Color::WHITE);
+	std::string black = getMaterialString(position, Color::BLACK);
+	int whiteWorth = getMaterialWorth(position, Color::WHITE);
+	int blackWorth = getMaterialWorth(position, Color::BLACK);
+	if (blackWorth > whiteWorth || (blackWorth == whiteWorth && (black.size() > white.size() || (black.size() == white.size() && black > white)))) {
+		for (int i = 0; i < position.numPieces; i++) {
+			position.colors[i] = Color::invert(position.colors[i]);
+			position.squares[i] ^= 0x70;
+		}
+		position.colorToMove = Color::invert(position.colorToMove);
+	}
+
+	// kings first, then by color and type, pieces of the same kind keep their order
+	TablebasePosition sorted = position;
+	int n = 0;
+	for (int color = 0; color < 2; color++) {
+		for (int i = 0; i < position.numPieces; i++) {
+			if (position.colors[i] == color && position.types[i] == Piece::King) {
+				sorted.colors[n] = color;
+				sorted.types[n] = Piece::King;
+				sorted.squares[n++] = position.squares[i];
+			}
+		}
+	}
+	for (int color = 0; color < 2; color++) {
+		for (int type = Piece::Queen; type >= Piece::Knight; type--) {
+			for (int i = 0; i < position.numPieces; i++) {
+				if (position.colors[i] == color && position.types[i] == type) {
+					sorted.colors[n] = color;
+					sorted.types[n] = (Piece::PieceType)type;
+					sorted.squares[n++] = position.squares[i];
+				}
+			}
+		}
+	}
+	position = sorted;
+}
+
+u64 Tablebase::getIndex(const TablebasePosition& position) {
+	// mirror the board so the white king is on the files a-d and the ranks 1-4
+	int mirror = 0;
+	if ((position.squares[0] & 7) >= 4) {
+		mirror ^= 7;
+	}
+	if ((position.squares[0] >> 4) >= 4) {
+		mirror ^= 0x70;
+	}
+
+	int whiteKing = position.squares[0] ^ mirror;
+	u64 index = position.colorToMove * 16 + (whiteKing >> 4) * 4 + (whiteKing & 7);
+	for (int i = 1; i < position.numPieces; i++) {
+		index = index * 64 + to64(position.squares[i] ^ mirror);
+	}
+	return index;
+}
+
+void Tablebase::decodeIndex(u64 index, TablebasePosition& position) {
+	for (int i = position.numPieces - 1; i > 0; i--) {
+		position.squares[i] = to88((int)(index & 63));
+		index >>= 6;
+	}
+	int whiteKing = (int)(index & 15);
+	position.squares[0] = (whiteKing >> 2) * 16 + (whiteKing & 3);
+	position.colorToMove = (int)(index >> 4);
+}
\ No newline at end of file
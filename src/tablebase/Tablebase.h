@@ -0,0 +1,79 @@
+#pragma once
+#include <string>
+#include "../types.h"
+#include "../Piece.h"
+
+// A pawnless position as stored in the tablebases.
+// Pawns would need promotions into the pawnless tables, en passant in the index and a retrograde move generator for pawns.
+// KPK, the pawn ending met most often, is decided exactly by the KPK bitbase instead.
+// The white king comes first, then the black king, the other white pieces and the other black pieces, each ordered by type.
+struct TablebasePosition
+{
+	static const int MAX_PIECES = 5;
+
+	int numPieces;
+	int colorToMove;
+	int colors[MAX_PIECES];
+	Piece::PieceType types[MAX_PIECES];
+	int squares[MAX_PIECES]; // 0x88
+};
+
+// Layout of a tablebase file: the header, the offsets of the blocks (numBlocks + 1) and the run length encoded blocks.
+// A block holds BLOCK_SIZE positions. It starts with the offsets of its sub-blocks (u16, from the start of the block),
+// the sub-blocks follow as pairs of run length and value. Runs end at the sub-blocks, so a probe reads only one of them.
+struct TablebaseHeader
+{
+	static const u32 MAGIC = 0x32425447; // GTB2
+	static const int BLOCK_SIZE = 4096;
+	static const int SUB_BLOCK_SIZE = 256;
+	static const int SUB_BLOCKS = BLOCK_SIZE / SUB_BLOCK_SIZE;
+
+	u32 magic;
+	u32 numBlocks;
+	u64 size;
+	char name[16];
+};
+
+// Naming, indexing and values of the tablebases.
+// The white king is mirrored into the a1-d4 quadrant, all other pieces may be on any square.
+class Tablebase
+{
+public:
+	// values are from the point of view of the side to move, otherwise the number of plies to mate + 1
+	static const u8 DRAW = 0;
+	static const u8 UNRESOLVED = 254;
+	static const u8 ILLEGAL = 255;
+	static const int MAX_PLIES = 252;
+
+	// very long mates keep their parity but not their length
+	static u8 encode(int plies) {
+		while (plies > MAX_PLIES) {
+			plies -= 2;
+		}
+		return (u8)(plies + 1);
+	}
+
+	static int getPlies(u8 value) {
+		return value - 1;
+	}
+
+	// the side to move gives mate if the number of plies is odd
+	static bool isWin(u8 value) {
+		return value != DRAW && value < UNRESOLVED && (getPlies(value) & 1) == 1;
+	}
+
+	static bool isLoss(u8 value) {
+		return value != DRAW && value < UNRESOLVED && (getPlies(value) & 1) == 0;
+	}
+
+	static u64 getSize(int numPieces);
+	// e.g. KRvKN, the stronger side is always white
+	static std::string getName(const TablebasePosition& position);
+	static bool parseName(std::string name, TablebasePosition& position);
+	// swaps the colors if the black pieces are stronger and orders the pieces, the value of the position does not change
+	static void normalize(TablebasePosition& position);
+	// index of a normalized position
+	static u64 getIndex(const TablebasePosition& position);
+	// sets the squares and the side to move of a position with the pieces of the table
+	static void decodeIndex(u64 index, TablebasePosition& position);
+};
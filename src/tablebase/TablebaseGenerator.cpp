@@ -0,0 +1,442 @@
+#include "TablebaseGenerator.h"
+#include "../DeltaTables.h"
+#include "../Color.h"
+
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+// marks positions which are not lost however the quiet moves turn out
+static const u8 NO_LOSS = 255;
+
+struct TablebaseMove
+{
+	int piece;
+	int destination;
+	int capturedPiece; // -1 for quiet moves
+};
+
+// slot of the piece on each 0x88 square, -1 for empty squares
+struct TablebaseOccupancy
+{
+	int slots[128];
+};
+
+static const int* getVectorMoves(Piece::PieceType type, int& numVectorMoves) {
+	switch (type) {
+	case Piece::Knight:
+		numVectorMoves = 8;
+		return Piece::KNIGHT_VECTORS;
+	case Piece::Bishop:
+		numVectorMoves = 4;
+		return Piece::BISHOP_VECTORS;
+	case Piece::Rook:
+		numVectorMoves = 4;
+		return Piece::ROOK_VECTORS;
+	default:
+		numVectorMoves = 8;
+		return Piece::KING_VECTORS;
+	}
+}
+
+// false if two pieces share a square
+static bool setupOccupancy(const TablebasePosition& position, TablebaseOccupancy& occupancy) {
+	std::fill(occupancy.slots, occupancy.slots + 128, -1);
+	for (int i = 0; i < position.numPieces; i++) {
+		if (occupancy.slots[position.squares[i]] >= 0) {
+			return false;
+		}
+		occupancy.slots[position.squares[i]] = i;
+	}
+	return true;
+}
+
+static bool isAttacked(const TablebasePosition& position, const TablebaseOccupancy& occupancy, int square, int color, int ignoredPiece = -1) {
+	for (int i = 0; i < position.numPieces; i++) {
+		if (i == ignoredPiece || position.colors[i] != color || !DeltaTables::canAttack(color, position.types[i], position.squares[i], square)) {
+			continue;
+		}
+		if (!Piece::isSliding(position.types[i])) {
+			return true;
+		}
+		int direction = DeltaTables::getDirection(position.squares[i], square);
+		int sq = position.squares[i] + direction;
+		while (sq != square && occupancy.slots[sq] < 0) {
+			sq += direction;
+		}
+		if (sq == square) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool isLegalPosition(const TablebasePosition& position, TablebaseOccupancy& occupancy) {
+	return setupOccupancy(position, occupancy) &&
+		DeltaTables::getDistance(position.squares[Color::WHITE], position.squares[Color::BLACK]) > 1 &&
+		!isAttacked(position, occupancy, position.squares[Color::invert(position.colorToMove)], position.colorToMove);
+}
+
+// pseudo legal moves of one side, captures of the king are left out
+static int generateMoves(const TablebasePosition& position, const TablebaseOccupancy& occupancy, int color, TablebaseMove* moves) {
+	int numMoves = 0;
+	for (int i = 0; i < position.numPieces; i++) {
+		if (position.colors[i] != color) {
+			continue;
+		}
+		int numVectorMoves;
+		const int* vectorMoves = getVectorMoves(position.types[i], numVectorMoves);
+		bool sliding = Piece::isSliding(position.types[i]);
+		for (int j = 0; j < numVectorMoves; j++) {
+			int dest = position.squares[i] + vectorMoves[j];
+			while ((dest & 0x88) == 0) {
+				int target = occupancy.slots[dest];
+				if (target >= 0) {
+					if (position.colors[target] != color && position.types[target] != Piece::King) {
+						moves[numMoves++] = { i, dest, target };
+					}
+					break;
+				}
+				moves[numMoves++] = { i, dest, -1 };
+				if (!sliding) {
+					break;
+				}
+				dest += vectorMoves[j];
+			}
+		}
+	}
+	return numMoves;
+}
+
+// true if the move does not leave the own king in check
+static bool isLegalMove(TablebasePosition& position, TablebaseOccupancy& occupancy, const TablebaseMove& move) {
+	int source = position.squares[move.piece];
+	int color = position.colors[move.piece];
+	occupancy.slots[source] = -1;
+	occupancy.slots[move.destination] = move.piece;
+	position.squares[move.piece] = move.destination;
+
+	bool legal = !isAttacked(position, occupancy, position.squares[color], Color::invert(color), move.capturedPiece);
+
+	position.squares[move.piece] = source;
+	occupancy.slots[source] = move.piece;
+	occupancy.slots[move.destination] = move.capturedPiece;
+	return legal;
+}
+
+// the position after a capture with the opponent to move, the captured piece is removed
+static TablebasePosition makeCapture(const TablebasePosition& position, const TablebaseMove& move) {
+	TablebasePosition next;
+	next.numPieces = 0;
+	next.colorToMove = Color::invert(position.colorToMove);
+	for (int i = 0; i < position.numPieces; i++) {
+		if (i == move.capturedPiece) {
+			continue;
+		}
+		next.colors[next.numPieces] = position.colors[i];
+		next.types[next.numPieces] = position.types[i];
+		next.squares[next.numPieces++] = i == move.piece ? move.destination : position.squares[i];
+	}
+	Tablebase::normalize(next);
+	return next;
+}
+
+TablebaseGenerator::TablebaseGenerator(int numThreads, bool verbose) {
+	this->numThreads = std::max(numThreads, 1);
+	this->verbose = verbose;
+}
+
+TablebaseGenerator::~TablebaseGenerator() {
+
+}
+
+bool TablebaseGenerator::generate(std::string name, std::string path) {
+	if (!solveTables(name)) {
+		return false;
+	}
+
+	for (auto it = tables.begin(); it != tables.end(); it++) {
+		if (!write(path + it->first + ".gtb", it->first, it->second)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TablebaseGenerator::solveTables(std::string name) {
+	TablebasePosition material;
+	if (!Tablebase::parseName(name, material)) {
+		std::cerr << "Invalid tablebase \'" << name << "\', expected e.g. KRvK or KQvKR with at most " << TablebasePosition::MAX_PIECES << " pieces and no pawns" << std::endl;
+		return false;
+	}
+
+	solveSubTables(material);
+	return true;
+}
+
+int TablebaseGenerator::getLongestMate(const std::string& name) {
+	auto it = tables.find(name);
+	if (it == tables.end()) {
+		return -1;
+	}
+	int longestMate = 0;
+	for (u64 index = 0; index < it->second.size(); index++) {
+		u8 value = it->second[index];
+		if (Tablebase::isWin(value) || Tablebase::isLoss(value)) {
+			longestMate = std::max(longestMate, Tablebase::getPlies(value));
+		}
+	}
+	return longestMate;
+}
+
+void TablebaseGenerator::solveSubTables(const TablebasePosition& material) {
+	if (tables.find(Tablebase::getName(material)) != tables.end()) {
+		return;
+	}
+	for (int i = 2; i < material.numPieces; i++) {
+		TablebaseMove capture = { 0, material.squares[0], i };
+		solveSubTables(makeCapture(material, capture));
+	}
+	solve(material);
+}
+
+template <class F>
+void TablebaseGenerator::runParallel(u64 n, F function) {
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; t++) {
+		threads.push_back(std::thread(function, t, n * t / numThreads, n * (t + 1) / numThreads));
+	}
+	for (int t = 0; t < numThreads; t++) {
+		threads[t].join();
+	}
+}
+
+void TablebaseGenerator::solve(const TablebasePosition& material) {
+	std::string name = Tablebase::getName(material);
+	u64 size = Tablebase::getSize(material.numPieces);
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	if (verbose) {
+		std::cout << "Solving " << name << " (" << size << " positions)..." << std::endl;
+	}
+
+	// the resolved tables of the captures, in the order of the captured pieces
+	const u8* subTables[TablebasePosition::MAX_PIECES] = { nullptr };
+	for (int i = 2; i < material.numPieces; i++) {
+		TablebaseMove capture = { 0, material.squares[0], i };
+		subTables[i] = tables[Tablebase::getName(makeCapture(material, capture))].data();
+	}
+
+	std::unique_ptr<std::atomic<u8>[]> values(new std::atomic<u8>[size]);
+	// number of legal quiet moves not yet known to lose
+	std::unique_ptr<std::atomic<u8>[]> counters(new std::atomic<u8>[size]);
+	// the longest loss by a capture, NO_LOSS if a capture draws or wins
+	std::unique_ptr<u8[]> captureLosses(new u8[size]);
+
+	// positions to resolve by the number of plies to mate, as index * 2 + 1 for wins and index * 2 for losses
+	std::vector<std::vector<u64>> buckets;
+	std::vector<std::vector<std::pair<int, u64>>> found(numThreads);
+
+	auto addFound = [&]() {
+		for (int t = 0; t < numThreads; t++) {
+			for (int i = 0; i < found[t].size(); i++) {
+				if (found[t][i].first >= buckets.size()) {
+					buckets.resize(found[t][i].first + 1);
+				}
+				buckets[found[t][i].first].push_back(found[t][i].second);
+			}
+			found[t].clear();
+		}
+	};
+
+	// mates, stalemates and the results of the captures
+	runParallel(size, [&](int thread, u64 begin, u64 end) {
+		TablebasePosition position = material;
+		TablebaseOccupancy occupancy;
+		TablebaseMove moves[128];
+		for (u64 index = begin; index < end; index++) {
+			Tablebase::decodeIndex(index, position);
+			counters[index] = 0;
+			captureLosses[index] = 0;
+			if (!isLegalPosition(position, occupancy)) {
+				values[index] = Tablebase::ILLEGAL;
+				continue;
+			}
+			values[index] = Tablebase::UNRESOLVED;
+
+			int numQuiets = 0;
+			int shortestWin = -1;
+			int longestLoss = 0;
+			bool hasLegalMove = false;
+			bool capturesDraw = false;
+			int n = generateMoves(position, occupancy, position.colorToMove, moves);
+			for (int i = 0; i < n; i++) {
+				if (!isLegalMove(position, occupancy, moves[i])) {
+					continue;
+				}
+				hasLegalMove = true;
+				if (moves[i].capturedPiece < 0) {
+					numQuiets++;
+					continue;
+				}
+				u8 value = subTables[moves[i].capturedPiece][Tablebase::getIndex(makeCapture(position, moves[i]))];
+				if (Tablebase::isLoss(value)) {
+					int plies = Tablebase::getPlies(value) + 1;
+					shortestWin = shortestWin < 0 ? plies : std::min(shortestWin, plies);
+				}
+				else if (Tablebase::isWin(value)) {
+					longestLoss = std::max(longestLoss, Tablebase::getPlies(value) + 1);
+				}
+				else {
+					capturesDraw = true;
+				}
+			}
+
+			counters[index] = numQuiets;
+			captureLosses[index] = capturesDraw || shortestWin >= 0 ? NO_LOSS : longestLoss;
+			if (!hasLegalMove) {
+				if (isAttacked(position, occupancy, position.squares[position.colorToMove], Color::invert(position.colorToMove))) {
+					found[thread].push_back(std::make_pair(0, index * 2));
+				}
+				else {
+					values[index] = Tablebase::DRAW;
+				}
+			}
+			else if (shortestWin >= 0) {
+				found[thread].push_back(std::make_pair(shortestWin, index * 2 + 1));
+			}
+			else if (numQuiets == 0) {
+				if (capturesDraw) {
+					values[index] = Tablebase::DRAW;
+				}
+				else {
+					found[thread].push_back(std::make_pair(longestLoss, index * 2));
+				}
+			}
+		}
+	});
+	addFound();
+
+	// retrograde passes, one per ply
+	int longestMate = 0;
+	for (int plies = 0; plies < buckets.size(); plies++) {
+		std::vector<u64>& bucket = buckets[plies];
+		runParallel(bucket.size(), [&](int thread, u64 begin, u64 end) {
+			TablebasePosition position = material;
+			TablebaseOccupancy occupancy;
+			TablebaseMove moves[128];
+			for (u64 i = begin; i < end; i++) {
+				u64 index = bucket[i] >> 1;
+				bool win = (bucket[i] & 1) != 0;
+				u8 expected = Tablebase::UNRESOLVED;
+				if (!values[index].compare_exchange_strong(expected, Tablebase::encode(plies))) {
+					continue;
+				}
+
+				// taking back the quiet moves of the opponent leads to the predecessors
+				Tablebase::decodeIndex(index, position);
+				setupOccupancy(position, occupancy);
+				int color = position.colorToMove;
+				int n = generateMoves(position, occupancy, Color::invert(color), moves);
+				for (int j = 0; j < n; j++) {
+					if (moves[j].capturedPiece >= 0) {
+						continue;
+					}
+					TablebasePosition previous = position;
+					previous.squares[moves[j].piece] = moves[j].destination;
+					previous.colorToMove = Color::invert(color);
+					u64 previousIndex = Tablebase::getIndex(previous);
+					if (values[previousIndex].load() != Tablebase::UNRESOLVED) {
+						continue;
+					}
+					if (!win) {
+						found[thread].push_back(std::make_pair(plies + 1, previousIndex * 2 + 1));
+					}
+					else if (counters[previousIndex].fetch_sub(1) == 1 && captureLosses[previousIndex] != NO_LOSS) {
+						found[thread].push_back(std::make_pair(std::max(plies + 1, (int)captureLosses[previousIndex]), previousIndex * 2));
+					}
+				}
+			}
+		});
+		if (!bucket.empty()) {
+			longestMate = plies;
+		}
+		std::vector<u64>().swap(bucket);
+		addFound();
+	}
+
+	// everything else is drawn
+	std::vector<u8>& table = tables[name];
+	table.resize(size);
+	u64 wins = 0;
+	u64 losses = 0;
+	u64 draws = 0;
+	for (u64 index = 0; index < size; index++) {
+		u8 value = values[index].load();
+		if (value == Tablebase::UNRESOLVED) {
+			value = Tablebase::DRAW;
+		}
+		wins += Tablebase::isWin(value) ? 1 : 0;
+		losses += Tablebase::isLoss(value) ? 1 : 0;
+		draws += value == Tablebase::DRAW ? 1 : 0;
+		table[index] = value;
+	}
+
+	if (verbose) {
+		int elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+		std::cout << name << ": " << wins << " wins, " << losses << " losses, " << draws << " draws, longest mate " << longestMate <<
+			" plies, " << (double)elapsed / 1000.0 << "s" << std::endl;
+	}
+}
+
+bool TablebaseGenerator::write(std::string filename, const std::string& name, const std::vector<u8>& values) {
+	TablebaseHeader header = {};
+	header.magic = TablebaseHeader::MAGIC;
+	header.numBlocks = (u32)((values.size() + TablebaseHeader::BLOCK_SIZE - 1) / TablebaseHeader::BLOCK_SIZE);
+	header.size = values.size();
+	name.copy(header.name, sizeof(header.name) - 1);
+
+	std::vector<u64> offsets;
+	std::vector<u8> data;
+	for (u64 block = 0; block < header.numBlocks; block++) {
+		offsets.push_back(data.size());
+		u64 blockBegin = data.size();
+		data.resize(blockBegin + TablebaseHeader::SUB_BLOCKS * sizeof(u16));
+		for (int subBlock = 0; subBlock < TablebaseHeader::SUB_BLOCKS; subBlock++) {
+			u16 subOffset = (u16)(data.size() - blockBegin);
+			memcpy(&data[blockBegin + subBlock * sizeof(u16)], &subOffset, sizeof(u16));
+			u64 i = std::min((u64)values.size(), block * TablebaseHeader::BLOCK_SIZE + subBlock * TablebaseHeader::SUB_BLOCK_SIZE);
+			u64 end = std::min((u64)values.size(), i + TablebaseHeader::SUB_BLOCK_SIZE);
+			while (i < end) {
+				// illegal positions are never probed, they extend the run of any value
+				u8 value = values[i];
+				int run = 0;
+				while (i < end && run < 255 && (values[i] == value || values[i] == Tablebase::ILLEGAL || value == Tablebase::ILLEGAL)) {
+					if (value == Tablebase::ILLEGAL) {
+						value = values[i];
+					}
+					i++;
+					run++;
+				}
+				data.push_back((u8)run);
+				data.push_back(value);
+			}
+		}
+	}
+	offsets.push_back(data.size());
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Tablebase file \'" << filename << "\' could not be opened!" << std::endl;
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)offsets.data(), offsets.size() * sizeof(u64));
+	file.write((const char*)data.data(), data.size());
+	std::cout << "Wrote " << filename << " (" << sizeof(header) + offsets.size() * sizeof(u64) + data.size() << " bytes)" << std::endl;
+	return file.good();
+}
\ No newline at end of file
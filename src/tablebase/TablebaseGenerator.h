@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "Tablebase.h"
+
+// Solves pawnless endgames by retrograde analysis.
+// Starting from the mates, each pass resolves the positions one ply further away from the end:
+// predecessors of lost positions are won, predecessors of won positions are lost once all their moves are known to lose.
+class TablebaseGenerator
+{
+public:
+	// verbose prints the progress of the solve
+	TablebaseGenerator(int numThreads, bool verbose = true);
+	~TablebaseGenerator();
+
+	// solves the table and all tables reachable by captures and writes them to the directory
+	bool generate(std::string name, std::string path);
+	// solves the tables without writing them
+	bool solveTables(std::string name);
+	// longest mate of a solved table in plies, -1 if the table is not solved
+	int getLongestMate(const std::string& name);
+	static bool write(std::string filename, const std::string& name, const std::vector<u8>& values);
+private:
+	void solve(const TablebasePosition& material);
+	void solveSubTables(const TablebasePosition& material);
+	template <class F>
+	void runParallel(u64 n, F function);
+
+	int numThreads;
+	bool verbose;
+	std::map<std::string, std::vector<u8>> tables;
+};
@@ -0,0 +1,155 @@
+#include "Tablebases.h"
+#include "../Board.h"
+
+#include <iostream>
+#include <cstring>
+
+Tablebases::Tablebases(std::string path) {
+	this->path = path;
+}
+
+Tablebases::~Tablebases() {
+	for (auto it = tables.begin(); it != tables.end(); it++) {
+		delete it->second;
+	}
+}
+
+bool Tablebases::probe(Board* board, int& score) {
+	if (path.empty() || board->getCastlingRights().getRaw() != 0) {
+		return false;
+	}
+
+	int numPieces = 0;
+	for (int c = 0; c < 2; c++) {
+		if (board->getPieceCount(c, Piece::Pawn) > 0) {
+			return false;
+		}
+		for (int type = Piece::King; type <= Piece::Queen; type++) {
+			numPieces += board->getPieceCount(c, (Piece::PieceType)type);
+		}
+	}
+	if (numPieces > TablebasePosition::MAX_PIECES) {
+		return false;
+	}
+
+	// most materials have no table, they are known after the first probe
+	auto it = tablesByMaterial.find(board->getMaterialKey());
+	bool known = it != tablesByMaterial.end();
+	if (known && it->second == nullptr) {
+		return false;
+	}
+
+	TablebasePosition position;
+	position.numPieces = 0;
+	position.colorToMove = board->getColorToMove();
+	for (int c = 0; c < 2; c++) {
+		std::vector<Piece*>* pieces = board->getPieceList(c);
+		for (int i = 0; i < pieces->size(); i++) {
+			Piece* p = (*pieces)[i];
+			if (p->alive) {
+				position.colors[position.numPieces] = c;
+				position.types[position.numPieces] = p->type;
+				position.squares[position.numPieces++] = p->square;
+			}
+		}
+	}
+
+	Tablebase::normalize(position);
+	u64 size = Tablebase::getSize(position.numPieces);
+	MappedFile* table;
+	if (known) {
+		table = it->second;
+	}
+	else {
+		table = getTable(Tablebase::getName(position), size);
+		tablesByMaterial[board->getMaterialKey()] = table;
+	}
+
+	u8 value;
+	if (table == nullptr || !readValue(table, size, Tablebase::getIndex(position), value)) {
+		return false;
+	}
+	if (value == Tablebase::DRAW) {
+		score = 0;
+	}
+	else {
+		int plies = Tablebase::getPlies(value);
+		score = Tablebase::isWin(value) ? WIN_SCORE - plies : -WIN_SCORE + plies;
+	}
+	return true;
+}
+
+bool Tablebases::probe(TablebasePosition& position, u8& value) {
+	Tablebase::normalize(position);
+	u64 size = Tablebase::getSize(position.numPieces);
+	MappedFile* table = getTable(Tablebase::getName(position), size);
+	return table != nullptr && readValue(table, size, Tablebase::getIndex(position), value);
+}
+
+bool Tablebases::readValue(MappedFile* table, u64 size, u64 index, u8& value) {
+	// the layout was checked when the file was opened
+	u64 numBlocks = (size + TablebaseHeader::BLOCK_SIZE - 1) / TablebaseHeader::BLOCK_SIZE;
+	const u8* offsets = table->getData() + sizeof(TablebaseHeader);
+	const u8* blocks = offsets + (numBlocks + 1) * sizeof(u64);
+	u64 block = index / TablebaseHeader::BLOCK_SIZE;
+	u64 blockBegin, blockEnd;
+	memcpy(&blockBegin, offsets + block * sizeof(u64), sizeof(u64));
+	memcpy(&blockEnd, offsets + (block + 1) * sizeof(u64), sizeof(u64));
+
+	const u8* data = blocks + blockBegin;
+	int subBlock = (int)(index % TablebaseHeader::BLOCK_SIZE) / TablebaseHeader::SUB_BLOCK_SIZE;
+	u16 begin;
+	u16 end = (u16)(blockEnd - blockBegin);
+	memcpy(&begin, data + subBlock * sizeof(u16), sizeof(u16));
+	if (subBlock + 1 < TablebaseHeader::SUB_BLOCKS) {
+		memcpy(&end, data + (subBlock + 1) * sizeof(u16), sizeof(u16));
+	}
+
+	// walk the runs of the sub-block up to the position
+	int remaining = (int)(index % TablebaseHeader::SUB_BLOCK_SIZE);
+	for (int i = begin; i + 1 < end; i += 2) {
+		if (remaining < data[i]) {
+			value = data[i + 1];
+			return value != Tablebase::ILLEGAL;
+		}
+		remaining -= data[i];
+	}
+	return false;
+}
+
+MappedFile* Tablebases::getTable(const std::string& name, u64 size) {
+	auto it = tables.find(name);
+	if (it != tables.end()) {
+		return it->second;
+	}
+
+	MappedFile* table = new MappedFile();
+	std::string filename = path + name + ".gtb";
+	if (table->open(filename)) {
+		TablebaseHeader header;
+		bool valid = table->getSize() >= sizeof(header);
+		if (valid) {
+			memcpy(&header, table->getData(), sizeof(header));
+			u64 dataStart = sizeof(header) + ((u64)header.numBlocks + 1) * sizeof(u64);
+			u64 dataSize = 0;
+			valid = header.magic == TablebaseHeader::MAGIC && header.size == size &&
+				header.numBlocks == (size + TablebaseHeader::BLOCK_SIZE - 1) / TablebaseHeader::BLOCK_SIZE &&
+				table->getSize() >= dataStart;
+			if (valid) {
+				memcpy(&dataSize, table->getData() + dataStart - sizeof(u64), sizeof(u64));
+				valid = table->getSize() >= dataStart + dataSize;
+			}
+		}
+		if (!valid) {
+			std::cerr << "Tablebase file \'" << filename << "\' is invalid!" << std::endl;
+			delete table;
+			table = nullptr;
+		}
+	}
+	else {
+		delete table;
+		table = nullptr;
+	}
+	tables[name] = table;
+	return table;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <map>
+#include <unordered_map>
+#include "Tablebase.h"
+#include "MappedFile.h"
+
+class Board;
+
+// Probes the generated tablebase files of a directory, each file is mapped on its first probe.
+class Tablebases
+{
+public:
+	// won positions score below the mates found by the search
+	static const int WIN_SCORE = 500000;
+
+	Tablebases(std::string path);
+	~Tablebases();
+
+	// exact score for the side to move, false if no table covers the position
+	bool probe(Board* board, int& score);
+	bool probe(TablebasePosition& position, u8& value);
+private:
+	MappedFile* getTable(const std::string& name, u64 size);
+	// value of a normalized position, the table holds size positions
+	static bool readValue(MappedFile* table, u64 size, u64 index, u8& value);
+
+	std::string path;
+	// nullptr for tables without a valid file
+	std::map<std::string, MappedFile*> tables;
+	// the tables by the material key of the board, so the search does not build names, both colors share one file
+	std::unordered_map<u64, MappedFile*> tablesByMaterial;
+};
@@ -1,4 +1,6 @@
 #pragma once
 
 typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
 typedef unsigned long long u64;
\ No newline at end of file